@@ -0,0 +1,130 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "SimulatedGame.h"
+#include "Data/SettingsCache.h"
+#include "Pausing/EffectClassifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+// Wall time of EffectClassifier over synthetic Magic Effect arrays the size of large load orders, at one to four
+// workers, with the default PauseVetoRules. Exits 1 if any worker count classifies differently from one worker.
+//
+//   palu_classify_bench [--repeat R]    median of R runs per size and worker count
+
+namespace palu::harness
+{
+
+namespace
+{
+	constexpr size_t FormCounts[] = { 5000, 10000, 20000, 50000 };
+
+	// mostly Value Modifiers over many actor values and casting types, a few Slow Time - as in large load orders
+	std::vector<RE::EffectSetting> SyntheticEffects(std::mt19937& random, const size_t count)
+	{
+		std::vector<RE::EffectSetting> effects(count);
+		for (size_t index = 0; index < count; ++index)
+		{
+			RE::EffectSetting& effect(effects[index]);
+			effect.formID = static_cast<RE::FormID>(((index / 2048) << 24) | (0x800 + index % 2048));
+			const unsigned int roll(random() % 100);
+			effect.data.archetype = roll < 45 ? RE::EffectSetting::Archetype::kValueModifier :
+				roll == 45 ? RE::EffectSetting::Archetype::kSlowTime :
+				static_cast<RE::EffectSetting::Archetype>(random() % static_cast<std::uint32_t>(RE::EffectSetting::Archetype::kTotal));
+			effect.data.castingType = static_cast<RE::MagicSystem::CastingType>(
+				random() % static_cast<std::uint32_t>(RE::MagicSystem::CastingType::kTotal));
+			effect.data.primaryAV = random() % 50 == 0 ? RE::ActorValue::kBowSpeedBonus :
+				static_cast<RE::ActorValue>(random() % static_cast<std::uint32_t>(RE::ActorValue::kTotal));
+		}
+		return effects;
+	}
+
+	double MedianMillis(std::vector<double>& samples)
+	{
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace palu;
+	using namespace palu::harness;
+	size_t repeat(15);
+	for (int arg = 1; arg + 1 < argc; arg += 2)
+	{
+		if (std::string(argv[arg]) == "--repeat")
+			repeat = std::max<size_t>(1, std::strtoull(argv[arg + 1], nullptr, 10));
+	}
+	InitializeLogging(false);
+
+	RE::TESDataHandler dataHandler;
+	const PauseVetoRules rules(PauseVetoRules::Compile(SettingsCache::Instance().PauseVetoRules(), std::string(), dataHandler));
+	std::printf("%u hardware threads, median of %zu runs\n", std::thread::hardware_concurrency(), repeat);
+	std::printf("%8s %8s %12s %12s %12s %12s %8s\n", "forms", "vetoed", "1 worker ms", "2 workers ms", "3 workers ms",
+		"4 workers ms", "default");
+	std::mt19937 random(1);
+	int failures(0);
+	for (const size_t count : FormCounts)
+	{
+		std::vector<RE::EffectSetting> effects(SyntheticEffects(random, count));
+		std::vector<RE::EffectSetting*> forms(count);
+		std::transform(effects.begin(), effects.end(), forms.begin(), [](RE::EffectSetting& effect) { return &effect; });
+
+		std::vector<RE::FormID> expected;
+		double millis[EffectClassifier::MaxWorkers];
+		for (size_t workers = 1; workers <= EffectClassifier::MaxWorkers; ++workers)
+		{
+			std::vector<double> samples;
+			for (size_t run = 0; run < repeat; ++run)
+			{
+				const auto started(std::chrono::steady_clock::now());
+				std::vector<RE::FormID> vetoed(EffectClassifier::Classify(forms, rules, workers));
+				samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+				std::sort(vetoed.begin(), vetoed.end());
+				if (workers == 1 && run == 0)
+				{
+					expected = std::move(vetoed);
+				}
+				else if (vetoed != expected)
+				{
+					++failures;
+				}
+			}
+			millis[workers - 1] = MedianMillis(samples);
+		}
+		std::printf("%8zu %8zu %12.3f %12.3f %12.3f %12.3f %8zu\n", count, expected.size(), millis[0], millis[1], millis[2],
+			millis[3], EffectClassifier::Workers(count));
+	}
+	if (failures != 0)
+	{
+		std::printf("FAIL %d runs classified differently from one worker\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Data/FormIDSet.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_set>
+
+// Probe cost of FormIDSet against the unordered_set of EffectSetting pointers it replaced, at slow-time set sizes for
+// load orders of 50 to 2000 mods. Probes follow the pre-pause check - every active effect on a heavily modded player,
+// almost all of them misses.
+//
+//   palu_formidset_bench [--probes N]    N probes per container and size
+
+namespace palu::harness
+{
+
+namespace
+{
+	// MGEF records and slow-time effects per mod, averaged over large load orders
+	constexpr size_t EffectsPerMod = 24;
+	constexpr size_t SlowTimePerMod = 2;
+	constexpr size_t ModCounts[] = { 50, 200, 500, 1000, 2000 };
+	// probes are repeated over one active effect list, as each pause check walks the same one
+	constexpr size_t ActiveEffects = 400;
+
+	template <typename Probe>
+	double NanosPerProbe(const size_t probes, Probe&& probe)
+	{
+		size_t found(0);
+		const auto started(std::chrono::steady_clock::now());
+		for (size_t index = 0; index < probes; ++index)
+		{
+			found += probe(index % ActiveEffects) ? 1 : 0;
+		}
+		const auto elapsed(std::chrono::steady_clock::now() - started);
+		// keep the loop from being optimised away
+		if (found == probes + 1)
+		{
+			std::printf("unreachable\n");
+		}
+		return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(probes);
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace palu::harness;
+	size_t probes(20000000);
+	for (int arg = 1; arg + 1 < argc; arg += 2)
+	{
+		if (std::string(argv[arg]) == "--probes")
+			probes = std::max<size_t>(ActiveEffects, std::strtoull(argv[arg + 1], nullptr, 10));
+	}
+
+	std::printf("%6s %8s %8s %14s %14s %8s\n", "mods", "effects", "set", "unordered ns", "FormIDSet ns", "speedup");
+	std::mt19937 random(1);
+	int failures(0);
+	for (const size_t mods : ModCounts)
+	{
+		// forms spread across the load order, each mod's FormIDs under its own index as the game assigns them
+		const size_t effectCount(mods * EffectsPerMod);
+		std::vector<RE::EffectSetting> effects(effectCount);
+		std::vector<RE::FormID> formIDs(effectCount);
+		for (size_t index = 0; index < effectCount; ++index)
+		{
+			const size_t mod(index / EffectsPerMod);
+			formIDs[index] = static_cast<RE::FormID>(((mod % 0xFE) << 24) | ((mod / 0xFE) << 12) | (0x800 + index % EffectsPerMod));
+		}
+
+		std::unordered_set<RE::EffectSetting*> pointers;
+		std::vector<RE::FormID> slowTime;
+		while (slowTime.size() < mods * SlowTimePerMod)
+		{
+			const size_t index(random() % effectCount);
+			if (pointers.insert(&effects[index]).second)
+			{
+				slowTime.push_back(formIDs[index]);
+			}
+		}
+		const palu::FormIDSet sorted(std::move(slowTime));
+
+		// the player's active effects, drawn from every loaded effect - about one in twelve is slow-time
+		std::vector<size_t> active(ActiveEffects);
+		for (size_t& index : active)
+		{
+			index = random() % effectCount;
+		}
+
+		const double hashed(NanosPerProbe(probes, [&](const size_t probe) { return pointers.contains(&effects[active[probe]]); }));
+		const double flat(NanosPerProbe(probes, [&](const size_t probe) { return sorted.contains(formIDs[active[probe]]); }));
+		for (const size_t index : active)
+		{
+			if (pointers.contains(&effects[index]) != sorted.contains(formIDs[index]))
+			{
+				++failures;
+			}
+		}
+		std::printf("%6zu %8zu %8zu %14.2f %14.2f %7.2fx\n", mods, effectCount, sorted.size(), hashed, flat, hashed / flat);
+	}
+	if (failures != 0)
+	{
+		std::printf("FAIL FormIDSet and unordered_set disagree on %d probes\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "SimulatedGame.h"
+#include "Data/SettingsCache.h"
+#include "Utilities/utils.h"
+
+#include <filesystem>
+
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/sinks/stdout_sinks.h>
+
+std::shared_ptr<spdlog::logger> PALULogger;
+
+namespace RE
+{
+	BSInputDeviceManager* BSInputDeviceManager::GetSingleton()
+	{
+		static BSInputDeviceManager singleton;
+		return &singleton;
+	}
+}
+
+namespace FileUtils
+{
+	// no game install - plugin data files are not read or written
+	std::wstring GetGamePath(void)
+	{
+		return std::wstring();
+	}
+}
+
+namespace StringUtils
+{
+	std::string FromUnicode(const std::wstring& input)
+	{
+		return std::filesystem::path(input).string();
+	}
+}
+
+namespace palu::harness
+{
+
+void InitializeLogging(const bool verbose)
+{
+	if (verbose)
+	{
+		PALULogger = spdlog::stdout_logger_st("PALU_Logger");
+		PALULogger->set_level(spdlog::level::trace);
+	}
+	else
+	{
+		PALULogger = std::make_shared<spdlog::logger>("PALU_Logger", std::make_shared<spdlog::sinks::null_sink_st>());
+		PALULogger->set_level(spdlog::level::off);
+	}
+}
+
+void ApplySettings(const std::string& name, const std::vector<std::string>& settings)
+{
+	const std::filesystem::path iniFile(std::filesystem::temp_directory_path() / ("palu_harness_" + name + ".ini"));
+	{
+		std::ofstream output(iniFile, std::ios::out | std::ios::trunc);
+		output << "[Pause]\n";
+		for (const std::string& setting : settings)
+		{
+			output << setting << '\n';
+		}
+	}
+	SettingsCache::Instance().Refresh(iniFile.string());
+}
+
+}
@@ -0,0 +1,287 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "SimulatedGame.h"
+#include "Data/SettingsCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+// Feeds synthetic input streams through InputListener and BSInputDeviceManager dispatch, as the game's input thread
+// does, for each input filter configuration. Reports dispatch time per event, heap allocations per event and p99 time
+// per dispatched chain. Exits 1 if dispatch allocated.
+//
+//   palu_input_bench [--seconds S] [--repeat R]    S seconds of synthetic input per stream, replayed R times
+
+namespace
+{
+	// every heap allocation in the process - the timed loops read it before and after
+	std::atomic<std::uint64_t> allocations{ 0 };
+}
+
+void* operator new(const std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* allocated = std::malloc(size ? size : 1))
+	{
+		return allocated;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* allocated) noexcept
+{
+	std::free(allocated);
+}
+
+void operator delete(void* allocated, const std::size_t) noexcept
+{
+	std::free(allocated);
+}
+
+namespace palu::harness
+{
+
+namespace
+{
+	// accepted events are counted, nothing is unpaused
+	struct CountAccepted
+	{
+		std::uint64_t* accepted;
+		void operator()() const { ++*accepted; }
+	};
+
+	// the engine delivers input once per frame, as a chain of the events since the last poll
+	template <typename Event>
+	struct Stream
+	{
+		std::vector<Event> events;
+		std::vector<RE::InputEvent*> chains;
+
+		// link events into per-frame chains, given the millisecond each event arrived
+		void Link(const std::vector<std::int64_t>& arrivals)
+		{
+			const std::int64_t frameMillis(std::chrono::duration_cast<std::chrono::milliseconds>(FrameInterval).count());
+			std::int64_t frame(-1);
+			for (size_t index = 0; index < events.size(); ++index)
+			{
+				if (arrivals[index] / frameMillis != frame)
+				{
+					frame = arrivals[index] / frameMillis;
+					chains.push_back(&events[index]);
+				}
+				else
+				{
+					events[index - 1].next = &events[index];
+				}
+			}
+		}
+	};
+
+	// 1000 Hz mouse - hand tremor of a few counts, with an occasional deliberate flick
+	Stream<RE::MouseMoveEvent> MouseStream(std::mt19937& random, const int seconds)
+	{
+		Stream<RE::MouseMoveEvent> stream;
+		std::vector<std::int64_t> arrivals;
+		std::uniform_int_distribution<int> tremor(-3, 3);
+		for (std::int64_t millis = 0; millis < seconds * 1000; ++millis)
+		{
+			RE::MouseMoveEvent event;
+			event.device.value = RE::INPUT_DEVICE::kMouse;
+			event.eventType.value = RE::INPUT_EVENT_TYPE::kMouseMove;
+			const bool flick(random() % 500 == 0);
+			event.mouseInputX = flick ? 120 : tremor(random);
+			event.mouseInputY = flick ? -80 : tremor(random);
+			stream.events.push_back(event);
+			arrivals.push_back(millis);
+		}
+		stream.Link(arrivals);
+		return stream;
+	}
+
+	// 1000 Hz thumbstick - drift around centre from a worn stick
+	Stream<RE::ThumbstickEvent> StickStream(std::mt19937& random, const int seconds)
+	{
+		Stream<RE::ThumbstickEvent> stream;
+		std::vector<std::int64_t> arrivals;
+		std::normal_distribution<float> drift(0.0f, 0.08f);
+		for (std::int64_t millis = 0; millis < seconds * 1000; ++millis)
+		{
+			RE::ThumbstickEvent event;
+			event.device.value = RE::INPUT_DEVICE::kGamepad;
+			event.eventType.value = RE::INPUT_EVENT_TYPE::kThumbstick;
+			event.idCode = random() % 2 == 0 ? 0x0B : 0x0C;
+			event.xValue = drift(random);
+			event.yValue = drift(random);
+			stream.events.push_back(event);
+			arrivals.push_back(millis);
+		}
+		stream.Link(arrivals);
+		return stream;
+	}
+
+	// bursts of key and gamepad button presses, a few milliseconds apart, a few times a second
+	Stream<RE::ButtonEvent> ButtonStream(std::mt19937& random, const int seconds)
+	{
+		Stream<RE::ButtonEvent> stream;
+		std::vector<std::int64_t> arrivals;
+		constexpr std::uint32_t Keys[] = { 0x11, 0x1E, 0x1F, 0x20, 0x2A, 0x1C, 0x39 };
+		constexpr std::uint32_t Buttons[] = { 0x0001, 0x0002, 0x1000, 0x2000, 0x4000 };
+		for (std::int64_t millis = 0; millis < seconds * 1000; millis += 150 + random() % 250)
+		{
+			const size_t burst(4 + random() % 12);
+			for (size_t press = 0; press < burst; ++press)
+			{
+				RE::ButtonEvent event;
+				const bool gamepad(random() % 3 == 0);
+				event.device.value = gamepad ? RE::INPUT_DEVICE::kGamepad : RE::INPUT_DEVICE::kKeyboard;
+				event.eventType.value = RE::INPUT_EVENT_TYPE::kButton;
+				event.idCode = gamepad ? Buttons[random() % std::size(Buttons)] : Keys[random() % std::size(Keys)];
+				event.value = press % 2 == 0 ? 1.0f : 0.0f;
+				stream.events.push_back(event);
+				arrivals.push_back(millis + static_cast<std::int64_t>(press * 3));
+			}
+		}
+		stream.Link(arrivals);
+		return stream;
+	}
+
+	struct Configuration
+	{
+		const char* name;
+		std::vector<std::string> settings;
+		// listening for unpause input, or registered but idle between pauses
+		bool enabled;
+	};
+
+	const std::vector<Configuration> Configurations = {
+		{ "default", {}, true },
+		{ "ignore all but keys", { "IgnoreMouseMove=1", "IgnoreThumbstick=1", "IgnoreKeyPressAndButton=1",
+			"UnpauseKeyboardKeys=0x1C, 0x39", "UnpauseGamepadButtons=0x1000" }, true },
+		{ "analog threshold", { "IgnoreMouseMove=0", "IgnoreThumbstick=0", "MouseMoveUnpauseThreshold=40",
+			"ThumbstickUnpauseThreshold=0.5" }, true },
+		{ "analog duration", { "IgnoreMouseMove=0", "IgnoreThumbstick=0", "MouseMoveUnpauseThreshold=40",
+			"ThumbstickUnpauseThreshold=0.5", "AnalogUnpauseDuration=0.25" }, true },
+		{ "ProfileInput", { "ProfileInput=1" }, true },
+		{ "persistent, idle", { "PersistentInputSink=1" }, false },
+	};
+
+	struct Result
+	{
+		std::uint64_t events = 0;
+		std::uint64_t accepted = 0;
+		std::uint64_t allocations = 0;
+		std::uint64_t nanos = 0;
+		std::vector<std::uint64_t> chainNanos;
+	};
+
+	template <typename Event>
+	Result Run(const Configuration& configuration, const Stream<Event>& stream, const int repeat)
+	{
+		ApplySettings("bench", configuration.settings);
+		Result result;
+		InputListener<CountAccepted> listener(CountAccepted{ &result.accepted }, SettingsCache::Instance().PersistentInputSink());
+		if (configuration.enabled)
+		{
+			listener.Enable();
+		}
+		RE::BSInputDeviceManager* input(RE::BSInputDeviceManager::GetSingleton());
+		result.events = stream.events.size() * static_cast<std::uint64_t>(repeat);
+		result.chainNanos.reserve(stream.chains.size() * static_cast<size_t>(repeat));
+
+		const std::uint64_t allocationsBefore(allocations.load(std::memory_order_relaxed));
+		for (int pass = 0; pass < repeat; ++pass)
+		{
+			for (RE::InputEvent* chain : stream.chains)
+			{
+				// the analog debounce reads the plugin clock - one frame per chain
+				PluginClock::Advance(FrameInterval);
+				const auto started(std::chrono::steady_clock::now());
+				input->SendEvent(&chain);
+				const std::uint64_t elapsed(static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+				result.nanos += elapsed;
+				result.chainNanos.push_back(elapsed);
+			}
+		}
+		result.allocations = allocations.load(std::memory_order_relaxed) - allocationsBefore;
+		listener.Disable();
+		return result;
+	}
+
+	void Report(const char* stream, Result& result)
+	{
+		std::sort(result.chainNanos.begin(), result.chainNanos.end());
+		const std::uint64_t p99(result.chainNanos.empty() ? 0 :
+			result.chainNanos[std::min(result.chainNanos.size() - 1, result.chainNanos.size() * 99 / 100)]);
+		const double events(static_cast<double>(std::max<std::uint64_t>(result.events, 1)));
+		std::printf("  %-8s %9llu events  %7.1f ns/event  %6.3f allocs/event  p99 %7llu ns/chain  %9llu accepted\n", stream,
+			static_cast<unsigned long long>(result.events), static_cast<double>(result.nanos) / events,
+			static_cast<double>(result.allocations) / events, static_cast<unsigned long long>(p99),
+			static_cast<unsigned long long>(result.accepted));
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace palu::harness;
+	int seconds(60);
+	int repeat(20);
+	for (int arg = 1; arg + 1 < argc; arg += 2)
+	{
+		const std::string option(argv[arg]);
+		if (option == "--seconds")
+			seconds = std::max(1, std::atoi(argv[arg + 1]));
+		else if (option == "--repeat")
+			repeat = std::max(1, std::atoi(argv[arg + 1]));
+	}
+	InitializeLogging(false);
+
+	std::mt19937 random(1);
+	const auto mouse(MouseStream(random, seconds));
+	const auto stick(StickStream(random, seconds));
+	const auto buttons(ButtonStream(random, seconds));
+
+	std::uint64_t allocated(0);
+	for (const Configuration& configuration : Configurations)
+	{
+		std::printf("%s\n", configuration.name);
+		Result mouseResult(Run(configuration, mouse, repeat));
+		Report("mouse", mouseResult);
+		Result stickResult(Run(configuration, stick, repeat));
+		Report("stick", stickResult);
+		Result buttonResult(Run(configuration, buttons, repeat));
+		Report("buttons", buttonResult);
+		allocated += mouseResult.allocations + stickResult.allocations + buttonResult.allocations;
+	}
+	if (allocated != 0)
+	{
+		std::printf("FAIL input dispatch made %llu allocations\n", static_cast<unsigned long long>(allocated));
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,556 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "SimulatedGame.h"
+#include "Data/SettingsCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+// Replays scripted game traces - Loading Menu open and close, kPreLoadGame, kSaveGame, input, slow-time effects - against
+// PauseController on a virtual clock, and reports Loading Menu close to freeze and input to unpause latency.
+//
+//   palu_harness [--verbose] trace...              scripted traces, expectations checked
+//   palu_harness [--verbose] --random N [--seed S]  N generated traces per settings profile, invariants checked
+//
+// Trace files hold one entry per line, # starts a comment:
+//   set Key=Value                  INI setting for this trace, all others default
+//   <ms> open | close              Loading Menu opened or closed
+//   <ms> preload | save            kPreLoadGame, kSaveGame messages
+//   <ms> input keyboard|mouse|gamepad button <IDCode>
+//   <ms> input keyboard char <character>
+//   <ms> input gamepad connect
+//   <ms> input mouse move <x> <y>
+//   <ms> input gamepad thumbstick <x> <y>
+//   <ms> input <event> + <event> ...   one chain of events, delivered together
+//   <ms> slowtime on|off           slow-time effect on the player
+//   <ms> controls on|off           player controls enabled
+//   <ms> cell loading|ready        readiness probe result
+//   <ms> destination <FormID>      load destination for learned delays
+//   <ms> expect <PauseState> | frozen | unfrozen
+//   <ms> end                       run on to here
+
+namespace palu::harness
+{
+
+namespace
+{
+	struct TraceEvent
+	{
+		std::chrono::milliseconds at;
+		std::string verb;
+		std::vector<std::string> args;
+		size_t line;
+	};
+
+	struct Trace
+	{
+		std::string name;
+		std::vector<std::string> settings;
+		std::vector<TraceEvent> events;
+	};
+
+	struct Latencies
+	{
+		std::vector<double> closeToFreeze;
+		std::vector<double> inputToUnpause;
+	};
+
+	double Milliseconds(const PluginClock::duration elapsed)
+	{
+		return std::chrono::duration<double, std::milli>(elapsed).count();
+	}
+
+	bool ParseTrace(const std::string& fileName, Trace& trace)
+	{
+		std::ifstream input(fileName);
+		if (!input)
+		{
+			std::cerr << fileName << ": cannot open\n";
+			return false;
+		}
+		trace.name = fileName;
+		std::string text;
+		for (size_t line = 1; std::getline(input, text); ++line)
+		{
+			text = text.substr(0, text.find('#'));
+			std::istringstream tokens(text);
+			std::string first;
+			if (!(tokens >> first))
+			{
+				continue;
+			}
+			if (first == "set")
+			{
+				std::string setting;
+				std::getline(tokens >> std::ws, setting);
+				trace.settings.push_back(setting);
+				continue;
+			}
+			TraceEvent event{ std::chrono::milliseconds(std::strtoll(first.c_str(), nullptr, 10)), {}, {}, line };
+			if (!(tokens >> event.verb))
+			{
+				std::cerr << fileName << ':' << line << ": missing event\n";
+				return false;
+			}
+			for (std::string arg; tokens >> arg;)
+			{
+				event.args.push_back(arg);
+			}
+			if (!trace.events.empty() && event.at < trace.events.back().at)
+			{
+				std::cerr << fileName << ':' << line << ": events out of order\n";
+				return false;
+			}
+			trace.events.push_back(std::move(event));
+		}
+		return true;
+	}
+
+	RE::INPUT_DEVICE ParseDevice(const std::string& device)
+	{
+		if (device == "mouse")
+			return RE::INPUT_DEVICE::kMouse;
+		if (device == "gamepad")
+			return RE::INPUT_DEVICE::kGamepad;
+		return RE::INPUT_DEVICE::kKeyboard;
+	}
+
+	// one trace against a fresh controller - failures are appended, latencies recorded
+	class TraceRun
+	{
+	public:
+		TraceRun(const Trace& trace, Latencies& latencies, std::vector<std::string>& failures) :
+			_trace(trace), _latencies(latencies), _failures(failures), _engine(_pump), _controller(_engine, std::filesystem::path()),
+			_listener(UnpauseOnInput{ &_controller }, SettingsCache::Instance().PersistentInputSink())
+		{
+			_engine.listener = &_listener;
+		}
+
+		~TraceRun()
+		{
+			// queued frame tasks hold lifecycle completions, release them while the scheduler is alive
+			_pump.Clear();
+			_engine.listener = nullptr;
+		}
+
+		void Run()
+		{
+			const PluginClock::time_point start(PluginClock::now());
+			_engine.cellReadyAt = start;
+			PluginClock::time_point nextFrame(start + FrameInterval);
+			Scheduler& scheduler(_controller.GetScheduler());
+			size_t next(0);
+			while (next < _trace.events.size())
+			{
+				// jump to the next event or frame - between those nothing the trace can observe changes
+				const PluginClock::time_point eventAt(start + _trace.events[next].at);
+				const PluginClock::time_point target(std::min(eventAt, nextFrame));
+				if (target > PluginClock::now())
+				{
+					PluginClock::Advance(target - PluginClock::now());
+				}
+				scheduler.Poll();
+				while (next < _trace.events.size() && start + _trace.events[next].at <= PluginClock::now())
+				{
+					Apply(_trace.events[next]);
+					scheduler.Poll();
+					++next;
+				}
+				if (nextFrame <= PluginClock::now())
+				{
+					_pump.RunFrame();
+					nextFrame += FrameInterval;
+					scheduler.Poll();
+				}
+				CheckWrites();
+			}
+		}
+
+		// generated traces run long enough for every pause to end by input or timeout
+		void CheckSettled()
+		{
+			if (_controller.State() != PauseState::Idle || _engine.frozen)
+			{
+				Fail(0, std::string("pause did not settle, state ") + PauseStateName(_controller.State()) +
+					(_engine.frozen ? " frozen" : " unfrozen"));
+			}
+		}
+
+	private:
+		void Apply(const TraceEvent& event)
+		{
+			const std::string arg(event.args.empty() ? std::string() : event.args[0]);
+			if (event.verb == "open")
+			{
+				_controller.OnLoadingMenuOpened();
+			}
+			else if (event.verb == "close")
+			{
+				_controller.OnLoadingMenuClosed();
+				if (_controller.State() == PauseState::Delaying)
+				{
+					_closedAt = PluginClock::now();
+				}
+			}
+			else if (event.verb == "preload")
+			{
+				_controller.SetIsLoading();
+			}
+			else if (event.verb == "save")
+			{
+				// as the kSaveGame handler
+				if (SettingsCache::Instance().PauseOnSave() && _controller.StartPause(true))
+				{
+					_controller.ProgressPause();
+					_closedAt = PluginClock::now();
+				}
+			}
+			else if (event.verb == "input")
+			{
+				SendInput(event);
+			}
+			else if (event.verb == "slowtime")
+			{
+				_engine.slowTime = arg == "on";
+			}
+			else if (event.verb == "controls")
+			{
+				_engine.controlsReady = arg == "on";
+			}
+			else if (event.verb == "cell")
+			{
+				_engine.cellReadyAt = arg == "ready" ? PluginClock::now() : PluginClock::time_point::max();
+			}
+			else if (event.verb == "destination")
+			{
+				_engine.destination = static_cast<std::uint32_t>(std::strtoul(arg.c_str(), nullptr, 0));
+			}
+			else if (event.verb == "expect")
+			{
+				Expect(event, arg);
+			}
+			else if (event.verb != "end")
+			{
+				Fail(event.line, "unknown event " + event.verb);
+			}
+		}
+
+		// one input event from device, type and values - null if not understood
+		static std::unique_ptr<RE::InputEvent> ParseInput(const std::vector<std::string>& spec)
+		{
+			std::unique_ptr<RE::InputEvent> input;
+			if (spec.size() < 2)
+			{
+				return input;
+			}
+			if (spec[1] == "button" && spec.size() > 2)
+			{
+				auto button(std::make_unique<RE::ButtonEvent>());
+				button->idCode = static_cast<std::uint32_t>(std::strtoul(spec[2].c_str(), nullptr, 0));
+				button->value = 1.0f;
+				button->eventType.value = RE::INPUT_EVENT_TYPE::kButton;
+				input = std::move(button);
+			}
+			else if (spec[1] == "char" && spec.size() > 2)
+			{
+				auto character(std::make_unique<RE::CharEvent>());
+				character->keyCode = static_cast<std::uint32_t>(std::strtoul(spec[2].c_str(), nullptr, 0));
+				character->eventType.value = RE::INPUT_EVENT_TYPE::kChar;
+				input = std::move(character);
+			}
+			else if (spec[1] == "connect")
+			{
+				input = std::make_unique<RE::InputEvent>();
+				input->eventType.value = RE::INPUT_EVENT_TYPE::kDeviceConnect;
+			}
+			else if (spec[1] == "move" && spec.size() > 3)
+			{
+				auto mouseMove(std::make_unique<RE::MouseMoveEvent>());
+				mouseMove->mouseInputX = std::atoi(spec[2].c_str());
+				mouseMove->mouseInputY = std::atoi(spec[3].c_str());
+				mouseMove->eventType.value = RE::INPUT_EVENT_TYPE::kMouseMove;
+				input = std::move(mouseMove);
+			}
+			else if (spec[1] == "thumbstick" && spec.size() > 3)
+			{
+				auto thumbstick(std::make_unique<RE::ThumbstickEvent>());
+				thumbstick->xValue = std::strtof(spec[2].c_str(), nullptr);
+				thumbstick->yValue = std::strtof(spec[3].c_str(), nullptr);
+				thumbstick->eventType.value = RE::INPUT_EVENT_TYPE::kThumbstick;
+				input = std::move(thumbstick);
+			}
+			if (input)
+			{
+				input->device.value = ParseDevice(spec[0]);
+			}
+			return input;
+		}
+
+		// events joined by + arrive as one chain, as the engine delivers a poll's worth of input
+		void SendInput(const TraceEvent& event)
+		{
+			std::vector<std::unique_ptr<RE::InputEvent>> chain;
+			std::vector<std::string> spec;
+			for (size_t arg = 0; arg <= event.args.size(); ++arg)
+			{
+				if (arg < event.args.size() && event.args[arg] != "+")
+				{
+					spec.push_back(event.args[arg]);
+					continue;
+				}
+				chain.push_back(ParseInput(spec));
+				if (!chain.back())
+				{
+					Fail(event.line, "input needs device, type and values");
+					return;
+				}
+				if (chain.size() > 1)
+				{
+					chain[chain.size() - 2]->next = chain.back().get();
+				}
+				spec.clear();
+			}
+			// latest input while frozen and listened for - filtered events before it do not count against the unpause
+			if (_engine.frozen && _engine.inputEnabled)
+			{
+				_inputAt = PluginClock::now();
+			}
+			RE::InputEvent* input(chain.front().get());
+			RE::BSInputDeviceManager::GetSingleton()->SendEvent(&input);
+		}
+
+		void Expect(const TraceEvent& event, const std::string& expected)
+		{
+			std::string actual(PauseStateName(_controller.State()));
+			if (expected == "frozen" || expected == "unfrozen")
+			{
+				actual = _engine.frozen ? "frozen" : "unfrozen";
+			}
+			if (actual != expected)
+			{
+				Fail(event.line, "expected " + expected + ", found " + actual);
+			}
+		}
+
+		// every freeze flag write must come from a frame task, and closes out any latency being measured
+		void CheckWrites()
+		{
+			for (; _checkedWrites < _engine.writes.size(); ++_checkedWrites)
+			{
+				const SimulatedEngine::FreezeWrite& write(_engine.writes[_checkedWrites]);
+				if (!write.inFrame)
+				{
+					Fail(0, "freeze flag written outside a frame task");
+				}
+				if (write.freeze && _closedAt != PluginClock::time_point())
+				{
+					_latencies.closeToFreeze.push_back(Milliseconds(write.at - _closedAt));
+					_closedAt = {};
+				}
+				else if (!write.freeze && _inputAt != PluginClock::time_point())
+				{
+					_latencies.inputToUnpause.push_back(Milliseconds(write.at - _inputAt));
+					_inputAt = {};
+				}
+			}
+		}
+
+		void Fail(const size_t line, const std::string& message)
+		{
+			_failures.push_back(_trace.name + ':' + std::to_string(line) + ": " + message);
+		}
+
+		const Trace& _trace;
+		Latencies& _latencies;
+		std::vector<std::string>& _failures;
+		FramePump _pump;
+		SimulatedEngine _engine;
+		PauseController _controller;
+		InputListener<UnpauseOnInput> _listener;
+		size_t _checkedWrites = 0;
+		PluginClock::time_point _closedAt;
+		PluginClock::time_point _inputAt;
+	};
+
+	// one load screen, sometimes taken over by a second, with input, saves and slow time mixed in at random
+	Trace GenerateTrace(std::mt19937& random, const std::string& name)
+	{
+		const auto between([&random](const int low, const int high) { return low + static_cast<int>(random() % (high - low + 1)); });
+		const auto chance([&random](const int percent) { return static_cast<int>(random() % 100) < percent; });
+		Trace trace{ name, {}, {} };
+		int now(0);
+		const auto add([&trace, &now](const std::string& verb, std::vector<std::string> args = {}) {
+			trace.events.push_back({ std::chrono::milliseconds(now), verb, std::move(args), 0 });
+		});
+		if (chance(5))
+		{
+			add("slowtime", { "on" });
+		}
+		if (chance(50))
+		{
+			add("preload");
+		}
+		add("cell", { "loading" });
+		add("open");
+		if (chance(10))
+		{
+			now += between(0, 300);
+			add("input", { "keyboard", "button", "0x1C" });
+		}
+		now += between(300, 4000);
+		add("close");
+		const int closed(now);
+		if (chance(15))
+		{
+			// a second load screen before the first pause froze
+			now += between(50, 900);
+			add("open");
+			now += between(300, 2000);
+			add("close");
+		}
+		if (chance(5))
+		{
+			now += between(0, 500);
+			add("save");
+		}
+		now = std::max(now, closed + between(0, 2500));
+		add("cell", { "ready" });
+		if (chance(80))
+		{
+			now += between(100, 6000);
+			add("input", { chance(50) ? "keyboard" : "gamepad", "button", chance(50) ? "0x1C" : "0x1000" });
+		}
+		// longest PauseDelay, CanUnpauseAfter and ResumeAfter in the profiles, with margin
+		now += 15000;
+		add("end");
+		return trace;
+	}
+
+	struct Profile
+	{
+		std::string name;
+		std::vector<std::string> settings;
+	};
+
+	const std::vector<Profile> Profiles = {
+		{ "delay", {} },
+		{ "frames", { "FreezeAfterFrames=30" } },
+		{ "ready", { "FreezeWhenReady=1" } },
+		{ "adaptive", { "AdaptivePauseDelay=1" } },
+		{ "window", { "CanUnpauseAfter=1.5", "PauseDelay=0.5" } },
+		{ "persistent", { "PersistentInputSink=1", "PauseOnSave=1" } },
+	};
+
+	void Report(const char* label, std::vector<double>& samples)
+	{
+		if (samples.empty())
+		{
+			std::printf("  %-24s no samples\n", label);
+			return;
+		}
+		std::sort(samples.begin(), samples.end());
+		const auto percentile([&samples](const double fraction) {
+			return samples[std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())))];
+		});
+		std::printf("  %-24s count %6zu  ms p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f\n", label, samples.size(),
+			percentile(0.5), percentile(0.9), percentile(0.99), samples.back());
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace palu::harness;
+	bool verbose(false);
+	size_t randomTraces(0);
+	std::uint32_t seed(1);
+	std::vector<std::string> files;
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		const std::string option(argv[arg]);
+		if (option == "--verbose")
+			verbose = true;
+		else if (option == "--random" && arg + 1 < argc)
+			randomTraces = std::strtoull(argv[++arg], nullptr, 10);
+		else if (option == "--seed" && arg + 1 < argc)
+			seed = static_cast<std::uint32_t>(std::strtoul(argv[++arg], nullptr, 10));
+		else
+			files.push_back(option);
+	}
+	InitializeLogging(verbose);
+
+	std::vector<std::string> failures;
+	const auto wallStart(std::chrono::steady_clock::now());
+	size_t traces(0);
+	for (const std::string& file : files)
+	{
+		Trace trace;
+		if (!ParseTrace(file, trace))
+		{
+			return 2;
+		}
+		ApplySettings("trace", trace.settings);
+		Latencies latencies;
+		const size_t failed(failures.size());
+		TraceRun(trace, latencies, failures).Run();
+		++traces;
+		std::printf("%s %s\n", failures.size() == failed ? "PASS" : "FAIL", file.c_str());
+		Report("menu close to freeze", latencies.closeToFreeze);
+		Report("input to unpause", latencies.inputToUnpause);
+	}
+
+	std::mt19937 random(seed);
+	for (const Profile& profile : Profiles)
+	{
+		if (randomTraces == 0)
+		{
+			break;
+		}
+		ApplySettings(profile.name, profile.settings);
+		Latencies latencies;
+		const size_t failed(failures.size());
+		for (size_t index = 0; index < randomTraces; ++index)
+		{
+			const Trace trace(GenerateTrace(random, profile.name + '#' + std::to_string(index)));
+			TraceRun run(trace, latencies, failures);
+			run.Run();
+			run.CheckSettled();
+			++traces;
+		}
+		std::printf("%s profile %s, %zu traces\n", failures.size() == failed ? "PASS" : "FAIL", profile.name.c_str(), randomTraces);
+		Report("menu close to freeze", latencies.closeToFreeze);
+		Report("input to unpause", latencies.inputToUnpause);
+	}
+
+	const double seconds(std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count());
+	std::printf("%zu traces in %.2f seconds, %.0f traces per second\n", traces, seconds, static_cast<double>(traces) / seconds);
+	for (const std::string& failure : failures)
+	{
+		std::printf("%s\n", failure.c_str());
+	}
+	return failures.empty() ? 0 : 1;
+}
@@ -0,0 +1,322 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+// Stand-in for the plugin's precompiled header, for the off-game harness. Declares only the RE:: and SKSE surface that
+// PauseController, InputListener and SettingsCache use, shaped like CommonLibSSE so the plugin sources compile unchanged.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+using namespace std::literals;
+
+// CommonLibSSE brings in spdlog ahead of the plugin log wrapper
+#include <spdlog/details/os.h>
+#include <spdlog/spdlog.h>
+#include "Utilities/LogWrapper.h"
+
+namespace RE
+{
+	using FormID = std::uint32_t;
+
+	struct BSFixedString
+	{
+	};
+
+	class TESForm
+	{
+	public:
+		// forms are never registered - nothing resolves
+		template <class T = TESForm>
+		static T* LookupByID(const FormID)
+		{
+			return nullptr;
+		}
+
+		[[nodiscard]] FormID GetFormID() const { return formID; }
+		[[nodiscard]] const char* GetName() const { return ""; }
+		const char* GetFormEditorID() const;
+		bool GetPlayable() const;
+
+		FormID formID = 0;
+	};
+
+	class BGSKeyword : public TESForm
+	{
+	};
+
+	enum class ActorValue : std::int32_t
+	{
+		kNone = -1,
+		kBowSpeedBonus = 78,
+		kTotal = 164
+	};
+
+	// no names known - rules give actor values by number
+	class ActorValueList
+	{
+	public:
+		static ActorValueList* GetSingleton()
+		{
+			static ActorValueList singleton;
+			return &singleton;
+		}
+
+		[[nodiscard]] ActorValue LookupActorValueByName(const std::string_view) const { return ActorValue::kNone; }
+	};
+
+	namespace MagicSystem
+	{
+		enum class CastingType : std::uint32_t
+		{
+			kConstantEffect = 0,
+			kFireAndForget,
+			kConcentration,
+			kScroll,
+			kTotal
+		};
+	}
+
+	class EffectSetting : public TESForm
+	{
+	public:
+		enum class Archetype : std::uint32_t
+		{
+			kValueModifier = 0,
+			kSlowTime = 37,
+			kTotal = 47
+		};
+
+		struct EffectSettingData
+		{
+			Archetype archetype = Archetype::kValueModifier;
+			MagicSystem::CastingType castingType = MagicSystem::CastingType::kConstantEffect;
+			ActorValue primaryAV = ActorValue::kNone;
+		};
+
+		[[nodiscard]] Archetype GetArchetype() const { return data.archetype; }
+		[[nodiscard]] bool HasKeyword(const BGSKeyword*) const { return false; }
+
+		EffectSettingData data;
+	};
+
+	// plugins are never loaded - plugin-relative FormIDs do not resolve
+	class TESDataHandler
+	{
+	public:
+		[[nodiscard]] FormID LookupFormID(const FormID, const std::string_view) { return 0; }
+	};
+
+	namespace stl
+	{
+		template <class E, class U>
+		struct enumeration
+		{
+			E value;
+			[[nodiscard]] U underlying() const { return static_cast<U>(value); }
+			[[nodiscard]] E get() const { return value; }
+		};
+	}
+
+	enum class INPUT_DEVICE : std::uint32_t
+	{
+		kKeyboard = 0,
+		kMouse,
+		kGamepad,
+		kVirtualKeyboard,
+		kTotal
+	};
+
+	enum class INPUT_EVENT_TYPE : std::uint32_t
+	{
+		kButton = 0,
+		kMouseMove,
+		kChar,
+		kThumbstick,
+		kDeviceConnect,
+		kKinect,
+		kNone
+	};
+
+	class ButtonEvent;
+
+	class InputEvent
+	{
+	public:
+		virtual ~InputEvent() = default;
+
+		[[nodiscard]] INPUT_DEVICE GetDevice() const { return device.get(); }
+		[[nodiscard]] INPUT_EVENT_TYPE GetEventType() const { return eventType.get(); }
+		[[nodiscard]] const ButtonEvent* AsButtonEvent() const;
+
+		stl::enumeration<INPUT_DEVICE, std::uint32_t> device;
+		stl::enumeration<INPUT_EVENT_TYPE, std::uint32_t> eventType;
+		InputEvent* next = nullptr;
+	};
+
+	class IDEvent : public InputEvent
+	{
+	public:
+		[[nodiscard]] std::uint32_t GetIDCode() const { return idCode; }
+
+		std::uint32_t idCode = 0;
+	};
+
+	class ButtonEvent : public IDEvent
+	{
+	public:
+		float value = 0.0f;
+		float heldDownSecs = 0.0f;
+	};
+
+	inline const ButtonEvent* InputEvent::AsButtonEvent() const
+	{
+		return GetEventType() == INPUT_EVENT_TYPE::kButton ? static_cast<const ButtonEvent*>(this) : nullptr;
+	}
+
+	class CharEvent : public InputEvent
+	{
+	public:
+		std::uint32_t keyCode = 0;
+	};
+
+	class MouseMoveEvent : public IDEvent
+	{
+	public:
+		std::int32_t mouseInputX = 0;
+		std::int32_t mouseInputY = 0;
+	};
+
+	class ThumbstickEvent : public IDEvent
+	{
+	public:
+		float xValue = 0.0f;
+		float yValue = 0.0f;
+	};
+
+	enum class BSEventNotifyControl : std::uint32_t
+	{
+		kContinue = 0,
+		kStop = 1
+	};
+
+	template <class Event>
+	class BSTEventSource;
+
+	template <class Event>
+	class BSTEventSink
+	{
+	public:
+		virtual ~BSTEventSink() = default;
+		virtual BSEventNotifyControl ProcessEvent(const Event* a_event, BSTEventSource<Event>* a_eventSource) = 0;
+	};
+
+	class BSSpinLock
+	{
+	public:
+		void Lock() { _mutex.lock(); }
+		void Unlock() { _mutex.unlock(); }
+
+	private:
+		std::recursive_mutex _mutex;
+	};
+
+	class BSSpinLockGuard
+	{
+	public:
+		explicit BSSpinLockGuard(BSSpinLock& lock) : _lock(lock) { _lock.Lock(); }
+		~BSSpinLockGuard() { _lock.Unlock(); }
+
+	private:
+		BSSpinLock& _lock;
+	};
+
+	// dispatches under its lock, as the game does
+	template <class Event>
+	class BSTEventSource
+	{
+	public:
+		void AddEventSink(BSTEventSink<Event>* sink)
+		{
+			BSSpinLockGuard locker(lock);
+			if (std::find(sinks.begin(), sinks.end(), sink) == sinks.end())
+			{
+				sinks.push_back(sink);
+			}
+		}
+
+		void RemoveEventSink(BSTEventSink<Event>* sink)
+		{
+			BSSpinLockGuard locker(lock);
+			sinks.erase(std::remove(sinks.begin(), sinks.end(), sink), sinks.end());
+		}
+
+		void SendEvent(const Event* event)
+		{
+			BSSpinLockGuard locker(lock);
+			for (BSTEventSink<Event>* sink : sinks)
+			{
+				if (sink->ProcessEvent(event, this) == BSEventNotifyControl::kStop)
+				{
+					break;
+				}
+			}
+		}
+
+		std::vector<BSTEventSink<Event>*> sinks;
+		mutable BSSpinLock lock;
+	};
+
+	class BSInputDeviceManager : public BSTEventSource<InputEvent*>
+	{
+	public:
+		static BSInputDeviceManager* GetSingleton();
+	};
+}
+
+class RecursiveLock
+{
+public:
+	void Lock() { _mutex.lock(); }
+	void Unlock() { _mutex.unlock(); }
+
+private:
+	std::recursive_mutex _mutex;
+};
+
+class RecursiveLockGuard
+{
+public:
+	explicit RecursiveLockGuard(RecursiveLock& lock) : _lock(lock) { _lock.Lock(); }
+	~RecursiveLockGuard() { _lock.Unlock(); }
+
+private:
+	RecursiveLock& _lock;
+};
@@ -0,0 +1,147 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Data/SettingsCache.h"
+#include "Pausing/GameEngine.h"
+#include "Pausing/InputListener.h"
+#include "Pausing/PauseController.h"
+#include "Utilities/PluginClock.h"
+
+namespace palu::harness
+{
+
+// plugin log to stdout when verbose, otherwise discarded
+void InitializeLogging(const bool verbose);
+// write [Pause] settings, one Key=Value per line, to a scratch INI and load it into SettingsCache
+void ApplySettings(const std::string& name, const std::vector<std::string>& settings);
+// game frames run at 60 per second
+constexpr PluginClock::duration FrameInterval{ 16666667 };
+
+// Stand-in for the game's main loop. Tasks queued during a frame run at the start of the next one, in queue order, as
+// SKSE's task interface runs them.
+class FramePump
+{
+public:
+	void Queue(std::function<void()> task) { _queued.push_back(std::move(task)); }
+
+	// tasks queued by these tasks wait for the next frame
+	void RunFrame()
+	{
+		std::vector<std::function<void()>> tasks;
+		tasks.swap(_queued);
+		_inFrame = true;
+		for (const auto& task : tasks)
+		{
+			task();
+		}
+		_inFrame = false;
+		++_frames;
+	}
+
+	// drop tasks still queued at the end of a trace, while the scheduler their completions refer to is alive
+	void Clear() { _queued.clear(); }
+
+	[[nodiscard]] bool InFrame() const { return _inFrame; }
+	[[nodiscard]] std::uint64_t Frames() const { return _frames; }
+
+private:
+	std::vector<std::function<void()>> _queued;
+	bool _inFrame = false;
+	std::uint64_t _frames = 0;
+};
+
+// as PauseHandler::UnpauseOnInput
+struct UnpauseOnInput
+{
+	PauseController* controller;
+	void operator()() const { controller->Unpause(); }
+};
+
+// GameEngine over scripted game state. Records every write to the freeze flag, and whether it came from a frame task.
+class SimulatedEngine : public GameEngine
+{
+public:
+	struct FreezeWrite
+	{
+		PluginClock::time_point at;
+		bool freeze;
+		bool inFrame;
+	};
+
+	explicit SimulatedEngine(FramePump& pump) : _pump(pump)
+	{
+		_probes.push_back({ "CellReady", [this] { return PluginClock::now() >= cellReadyAt; } });
+	}
+
+	[[nodiscard]] bool CanFreeze() override { return !slowTime; }
+	[[nodiscard]] bool ControlsReady() override { return controlsReady; }
+	[[nodiscard]] const std::vector<ReadinessProbe>& ReadinessProbes() override { return _probes; }
+	[[nodiscard]] std::uint32_t DestinationKey() override { return destination; }
+
+	void SetFreezeTime(const bool freeze) override
+	{
+		frozen = freeze;
+		writes.push_back({ PluginClock::now(), freeze, _pump.InFrame() });
+	}
+
+	void QueueFrameTask(std::function<void()> task) override { _pump.Queue(std::move(task)); }
+
+	void EnableInput() override
+	{
+		inputEnabled = true;
+		if (listener)
+		{
+			listener->Enable();
+		}
+	}
+
+	void DisableInput() override
+	{
+		inputEnabled = false;
+		if (listener)
+		{
+			listener->Disable();
+		}
+	}
+
+	// scripted game state
+	bool slowTime = false;
+	bool controlsReady = true;
+	PluginClock::time_point cellReadyAt;
+	std::uint32_t destination = 0;
+	InputListener<UnpauseOnInput>* listener = nullptr;
+
+	// observed
+	bool frozen = false;
+	bool inputEnabled = false;
+	std::vector<FreezeWrite> writes;
+
+private:
+	FramePump& _pump;
+	std::vector<ReadinessProbe> _probes;
+};
+
+}
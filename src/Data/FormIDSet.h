@@ -0,0 +1,83 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace palu
+{
+
+// Immutable set of FormIDs in one sorted contiguous array, built once at data load or viewed in place from a mapped
+// file. Lookup is a branchless binary search, so a probe touches a handful of cache lines and never hashes.
+class FormIDSet
+{
+public:
+	FormIDSet() = default;
+	explicit FormIDSet(std::vector<RE::FormID>&& formIDs) : _formIDs(std::move(formIDs))
+	{
+		std::sort(_formIDs.begin(), _formIDs.end());
+		_formIDs.erase(std::unique(_formIDs.begin(), _formIDs.end()), _formIDs.end());
+		_formIDs.shrink_to_fit();
+		_view = _formIDs;
+	}
+
+	// moves keep the view valid, the vector's storage moves with it
+	FormIDSet(const FormIDSet&) = delete;
+	FormIDSet(FormIDSet&&) = default;
+	FormIDSet& operator=(const FormIDSet&) = delete;
+	FormIDSet& operator=(FormIDSet&&) = default;
+
+	// view over storage owned elsewhere, which must stay alive and already be sorted without duplicates
+	[[nodiscard]] static FormIDSet View(const std::span<const RE::FormID> sorted)
+	{
+		FormIDSet formIDs;
+		formIDs._view = sorted;
+		return formIDs;
+	}
+
+	[[nodiscard]] bool contains(const RE::FormID formID) const
+	{
+		size_t length(_view.size());
+		if (length == 0)
+		{
+			return false;
+		}
+		// narrow to the last element not greater than formID
+		const RE::FormID* base(_view.data());
+		while (length > 1)
+		{
+			const size_t half(length / 2);
+			base += base[half] <= formID ? half : 0;
+			length -= half;
+		}
+		return *base == formID;
+	}
+
+	[[nodiscard]] size_t size() const { return _view.size(); }
+	[[nodiscard]] const std::span<const RE::FormID>& FormIDs() const { return _view; }
+
+private:
+	std::vector<RE::FormID> _formIDs;
+	std::span<const RE::FormID> _view;
+};
+
+}
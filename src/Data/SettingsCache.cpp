@@ -19,6 +19,8 @@ http://www.fsf.org/licensing/licenses
 *************************************************************************/
 #include "PrecompiledHeaders.h"
 
+#include <cstdlib>
+
 #include "Data/SimpleIni.h"
 #include "Data/SettingsCache.h"
 #include "Utilities/utils.h"
@@ -38,16 +40,20 @@ SettingsCache& SettingsCache::Instance()
 }
 
 void SettingsCache::Refresh(void)
+{
+	Refresh(StringUtils::FromUnicode(GetFileName()));
+}
+
+void SettingsCache::Refresh(const std::string& iniFile)
 {
 	SimpleIni ini;
-	const std::wstring inFile(GetFileName());
-	if (!ini.Load(StringUtils::FromUnicode(inFile)))
+	if (!ini.Load(iniFile))
 	{
-		REL_WARNING("Settings cache load from {} failed, using defaults", StringUtils::FromUnicode(inFile));
+		REL_WARNING("Settings cache load from {} failed, using defaults", iniFile);
 	}
 	else
 	{
-		REL_MESSAGE("Refresh settings cache from valid file {}", StringUtils::FromUnicode(inFile));
+		REL_MESSAGE("Refresh settings cache from valid file {}", iniFile);
 		for (auto section = ini.beginSection(); section != ini.endSection(); ++section)
 		{
 			DBG_MESSAGE("Section {}", *section);
@@ -64,6 +70,12 @@ void SettingsCache::Refresh(void)
 	REL_VMESSAGE("CanUnpauseAfter = {:.1f} seconds", _canUnpauseAfter);
 	_pauseDelay = ini.GetValue<double>(SectionName, "pausedelay", DefaultPauseDelay);
 	REL_VMESSAGE("PauseDelay = {:.1f} seconds", _pauseDelay);
+	_freezeAfterFrames = static_cast<unsigned int>(std::max(0, ini.GetValue<int>(SectionName, "freezeafterframes", DefaultFreezeAfterFrames)));
+	REL_VMESSAGE("FreezeAfterFrames = {}", _freezeAfterFrames);
+	_adaptivePauseDelay = ini.GetValue<bool>(SectionName, "adaptivepausedelay", DefaultAdaptivePauseDelay);
+	REL_VMESSAGE("AdaptivePauseDelay = {}", _adaptivePauseDelay);
+	_freezeWhenReady = ini.GetValue<bool>(SectionName, "freezewhenready", DefaultFreezeWhenReady);
+	REL_VMESSAGE("FreezeWhenReady = {}", _freezeWhenReady);
 	_pauseOnSave = ini.GetValue<bool>(SectionName, "pauseonsave", DefaultPauseOnSave);
 	REL_VMESSAGE("PauseOnSave = {}", _pauseOnSave);
 	_pauseOnLoad = ini.GetValue<bool>(SectionName, "pauseonload", DefaultPauseOnLoad);
@@ -76,7 +88,31 @@ void SettingsCache::Refresh(void)
 	REL_VMESSAGE("IgnoreMouseMove = {}", _ignoreMouseMove);
 	_ignoreThumbstick = ini.GetValue<bool>(SectionName, "ignorethumbstick", DefaultIgnoreThumbstick);
 	REL_VMESSAGE("IgnoreThumbstick = {}", _ignoreThumbstick);
-	if (_ignoreKeyPressAndButton && _ignoreMouseMove && _ignoreThumbstick && _resumeAfter == 0.0)
+	_thumbstickUnpauseThreshold = std::clamp(
+		ini.GetValue<double>(SectionName, "thumbstickunpausethreshold", DefaultThumbstickUnpauseThreshold), 0.0, 1.0);
+	REL_VMESSAGE("ThumbstickUnpauseThreshold = {:.2f}", _thumbstickUnpauseThreshold);
+	_mouseMoveUnpauseThreshold = std::max(0.0,
+		ini.GetValue<double>(SectionName, "mousemoveunpausethreshold", DefaultMouseMoveUnpauseThreshold));
+	REL_VMESSAGE("MouseMoveUnpauseThreshold = {:.1f}", _mouseMoveUnpauseThreshold);
+	_analogUnpauseDuration = std::max(0.0, ini.GetValue<double>(SectionName, "analogunpauseduration", DefaultAnalogUnpauseDuration));
+	REL_VMESSAGE("AnalogUnpauseDuration = {:.2f} seconds", _analogUnpauseDuration);
+	// string GetValue keeps the whole value - the template stops at the first space
+	_unpauseKeys[0] = ParseUnpauseKeys(ini.GetValue(SectionName, "unpausekeyboardkeys", std::string()), "UnpauseKeyboardKeys");
+	_unpauseKeys[1] = ParseUnpauseKeys(ini.GetValue(SectionName, "unpausemousebuttons", std::string()), "UnpauseMouseButtons");
+	_unpauseKeys[2] = ParseUnpauseKeys(ini.GetValue(SectionName, "unpausegamepadbuttons", std::string()), "UnpauseGamepadButtons");
+	_persistentInputSink = ini.GetValue<bool>(SectionName, "persistentinputsink", DefaultPersistentInputSink);
+	REL_VMESSAGE("PersistentInputSink = {}", _persistentInputSink);
+	_pauseVetoRules = ini.GetValue(SectionName, "pausevetorules", DefaultPauseVetoRules());
+	REL_VMESSAGE("PauseVetoRules = {}", _pauseVetoRules);
+	_pauseVetoFormIDs = ini.GetValue(SectionName, "pausevetoformids", std::string());
+	REL_VMESSAGE("PauseVetoFormIDs = {}", _pauseVetoFormIDs);
+	_dumpTimeline = ini.GetValue<bool>(SectionName, "dumptimeline", DefaultDumpTimeline);
+	REL_VMESSAGE("DumpTimeline = {}", _dumpTimeline);
+	_profileInput = ini.GetValue<bool>(SectionName, "profileinput", DefaultProfileInput);
+	REL_VMESSAGE("ProfileInput = {}", _profileInput);
+	const bool anyUnpauseKeys(std::any_of(_unpauseKeys.cbegin(), _unpauseKeys.cend(),
+		[](const UnpauseKeySet& keys) { return keys.any(); }));
+	if (_ignoreKeyPressAndButton && !anyUnpauseKeys && _ignoreMouseMove && _ignoreThumbstick && _resumeAfter == 0.0)
 	{
 		// all user input disallowed - must configure auto-resume
 		REL_VMESSAGE("Override ResumeAfter - all user input disallowed");
@@ -84,15 +120,59 @@ void SettingsCache::Refresh(void)
 	}
 }
 
+std::string SettingsCache::DefaultPauseVetoRules()
+{
+	const std::string notConstant(",casting:!" + std::to_string(static_cast<std::uint32_t>(RE::MagicSystem::CastingType::kConstantEffect)));
+	return "archetype:" + std::to_string(static_cast<std::uint32_t>(RE::EffectSetting::Archetype::kSlowTime)) + notConstant +
+		PauseVetoRuleSeparator + "archetype:" + std::to_string(static_cast<std::uint32_t>(RE::EffectSetting::Archetype::kValueModifier)) +
+		",av:" + std::to_string(static_cast<std::uint32_t>(RE::ActorValue::kBowSpeedBonus)) + notConstant;
+}
+
+// comma-separated IDCodes, decimal or 0x-prefixed hex
+SettingsCache::UnpauseKeySet SettingsCache::ParseUnpauseKeys(const std::string& keyList, const char* name)
+{
+	UnpauseKeySet keys;
+	size_t start(0);
+	while (start < keyList.length())
+	{
+		size_t end(keyList.find(',', start));
+		if (end == std::string::npos)
+		{
+			end = keyList.length();
+		}
+		const std::string token(keyList.substr(start, end - start));
+		start = end + 1;
+		if (token.find_first_not_of(" \t") == std::string::npos)
+		{
+			continue;
+		}
+		char* parsed(nullptr);
+		const unsigned long key(std::strtoul(token.c_str(), &parsed, 0));
+		if (parsed == token.c_str() || token.find_first_not_of(" \t", parsed - token.c_str()) != std::string::npos || key >= keys.size())
+		{
+			REL_WARNING("{} entry '{}' is not a valid IDCode, ignored", name, token);
+			continue;
+		}
+		keys.set(key);
+	}
+	REL_VMESSAGE("{} = {} keys", name, keys.count());
+	return keys;
+}
+
 const std::wstring SettingsCache::GetFileName() const
 {
-	std::wstring iniFilePath;
+	return GetDataFileName(IniFileName);
+}
+
+const std::wstring SettingsCache::GetDataFileName(const wchar_t* fileName) const
+{
+	std::wstring dataFilePath;
 	std::wstring RuntimeDir = FileUtils::GetGamePath();
 	if (RuntimeDir.empty())
 		return L"";
 
-	iniFilePath = RuntimeDir + L"Data\\SKSE\\Plugins\\" + IniFileName;
-	return iniFilePath;
+	dataFilePath = RuntimeDir + L"Data\\SKSE\\Plugins\\" + fileName;
+	return dataFilePath;
 }
 
 }
\ No newline at end of file
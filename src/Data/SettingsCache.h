@@ -19,15 +19,28 @@ http://www.fsf.org/licensing/licenses
 >>> END OF LICENSE >>>
 *************************************************************************/
 
+#include <array>
+#include <bitset>
+#include <string>
+
 namespace palu
 {
 
 class SettingsCache {
 public:
+	// one bit per button IDCode - DirectInput scan code for keyboard, button index for mouse, XInput mask for gamepad
+	using UnpauseKeySet = std::bitset<0x10000>;
+	// keyboard, mouse and gamepad, in INPUT_DEVICE order
+	static constexpr size_t UnpauseKeyDevices = 3;
+	// separates PauseVetoRules entries - ; and # start an INI comment
+	static constexpr char PauseVetoRuleSeparator = '/';
+
 	static SettingsCache& Instance();
 	SettingsCache() = default;
 
 	void Refresh();
+	// load from the given INI instead of the plugin's own
+	void Refresh(const std::string& iniFile);
 
 	// time out the pause - set in seconds - 0.0 means wait for user input before resuming
 	[[nodiscard]] double ResumeAfter() const { return _resumeAfter; }
@@ -35,6 +48,12 @@ public:
 	[[nodiscard]] double CanUnpauseAfter() const { return _canUnpauseAfter; }
 	// delay the pause of the game engine to allow CELL setup to complete
 	[[nodiscard]] double PauseDelay() const { return _pauseDelay; }
+	// freeze from the game thread after this many rendered frames instead of PauseDelay - 0 means use PauseDelay
+	[[nodiscard]] unsigned int FreezeAfterFrames() const { return _freezeAfterFrames; }
+	// replace PauseDelay with a value learned per destination CELL or worldspace
+	[[nodiscard]] bool AdaptivePauseDelay() const { return _adaptivePauseDelay; }
+	// freeze as soon as all readiness probes pass instead of after PauseDelay
+	[[nodiscard]] bool FreezeWhenReady() const { return _freezeWhenReady; }
 	//optional pause-on-save
 	[[nodiscard]] bool PauseOnSave() const { return _pauseOnSave; }
 	//optional pause-on-save
@@ -45,9 +64,31 @@ public:
 	[[nodiscard]] bool IgnoreKeyPressAndButton() const { return _ignoreKeyPressAndButton; }
 	[[nodiscard]] bool IgnoreMouseMove() const { return _ignoreMouseMove; }
 	[[nodiscard]] bool IgnoreThumbstick() const { return _ignoreThumbstick; }
+	// analog unpause needs thumbstick deflection (0.0 to 1.0) or mouse movement per event at or above the threshold,
+	// sustained for the duration in seconds - 0.0 means any movement
+	[[nodiscard]] double ThumbstickUnpauseThreshold() const { return _thumbstickUnpauseThreshold; }
+	[[nodiscard]] double MouseMoveUnpauseThreshold() const { return _mouseMoveUnpauseThreshold; }
+	[[nodiscard]] double AnalogUnpauseDuration() const { return _analogUnpauseDuration; }
+	// buttons on the device allowed to unpause, overriding IgnoreKeyPressAndButton - none set means no restriction
+	[[nodiscard]] const UnpauseKeySet& UnpauseKeys(const size_t device) const { return _unpauseKeys[device]; }
+	// register the input listener once at startup and gate it with a flag, instead of registering on every pause
+	[[nodiscard]] bool PersistentInputSink() const { return _persistentInputSink; }
+	// Magic Effects that block the pause while active on the player - rules, and explicit FormIDs
+	[[nodiscard]] const std::string& PauseVetoRules() const { return _pauseVetoRules; }
+	[[nodiscard]] const std::string& PauseVetoFormIDs() const { return _pauseVetoFormIDs; }
+	// append pause phase timeline and latency histograms to a file after each pause
+	[[nodiscard]] bool DumpTimeline() const { return _dumpTimeline; }
+	// time input dispatch on the input thread, reported in the timeline dump
+	[[nodiscard]] bool ProfileInput() const { return _profileInput; }
+
+	// full path for a plugin data file alongside the INI
+	const std::wstring GetDataFileName(const wchar_t* fileName) const;
 
 private:
 	const std::wstring GetFileName() const;
+	static UnpauseKeySet ParseUnpauseKeys(const std::string& keyList, const char* name);
+	// non-constant-cast SlowTime, and non-constant-cast ValueModifier on BowSpeedBonus
+	static std::string DefaultPauseVetoRules();
 
 	static std::unique_ptr<SettingsCache> m_instance;
 
@@ -57,22 +98,43 @@ private:
 	static constexpr double DefaultResumeAfter = 5.0;
 	static constexpr double DefaultCanUnpauseAfter = 0.0;
 	static constexpr double DefaultPauseDelay = 1.0;
+	static constexpr int DefaultFreezeAfterFrames = 0;
+	static constexpr bool DefaultAdaptivePauseDelay = false;
+	static constexpr bool DefaultFreezeWhenReady = false;
 	static constexpr bool DefaultPauseOnSave = false;
 	static constexpr bool DefaultPauseOnLoad = true;
 	static constexpr bool DefaultPauseOnLoadScreen = true;
 	static constexpr bool DefaultIgnoreKeyPressAndButton = false;
 	static constexpr bool DefaultIgnoreMouseMove = true;
 	static constexpr bool DefaultIgnoreThumbstick = true;
+	static constexpr bool DefaultPersistentInputSink = false;
+	static constexpr double DefaultThumbstickUnpauseThreshold = 0.0;
+	static constexpr double DefaultMouseMoveUnpauseThreshold = 0.0;
+	static constexpr double DefaultAnalogUnpauseDuration = 0.0;
+	static constexpr bool DefaultDumpTimeline = false;
+	static constexpr bool DefaultProfileInput = false;
 
 	double _resumeAfter = DefaultResumeAfter;
 	double _canUnpauseAfter = DefaultCanUnpauseAfter;
 	double _pauseDelay = DefaultPauseDelay;
+	unsigned int _freezeAfterFrames = DefaultFreezeAfterFrames;
+	bool _adaptivePauseDelay = DefaultAdaptivePauseDelay;
+	bool _freezeWhenReady = DefaultFreezeWhenReady;
 	bool _pauseOnSave = DefaultPauseOnSave;
 	bool _pauseOnLoad = DefaultPauseOnLoad;
 	bool _pauseOnLoadScreen = DefaultPauseOnLoadScreen;
 	bool _ignoreKeyPressAndButton = DefaultIgnoreKeyPressAndButton;
 	bool _ignoreMouseMove = DefaultIgnoreMouseMove;
 	bool _ignoreThumbstick = DefaultIgnoreThumbstick;
+	double _thumbstickUnpauseThreshold = DefaultThumbstickUnpauseThreshold;
+	double _mouseMoveUnpauseThreshold = DefaultMouseMoveUnpauseThreshold;
+	double _analogUnpauseDuration = DefaultAnalogUnpauseDuration;
+	std::array<UnpauseKeySet, UnpauseKeyDevices> _unpauseKeys;
+	bool _persistentInputSink = DefaultPersistentInputSink;
+	std::string _pauseVetoRules = DefaultPauseVetoRules();
+	std::string _pauseVetoFormIDs;
+	bool _dumpTimeline = DefaultDumpTimeline;
+	bool _profileInput = DefaultProfileInput;
 };
 
 }
\ No newline at end of file
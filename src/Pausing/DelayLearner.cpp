@@ -0,0 +1,157 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/DelayLearner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace palu
+{
+
+DelayLearner::DelayLearner(const std::filesystem::path& fileName) : _fileName(fileName)
+{
+	Load();
+}
+
+size_t DelayLearner::Home(const std::uint32_t key)
+{
+	// Fibonacci hashing - FormIDs cluster in the low bits of each plugin's range
+	return static_cast<size_t>((key * 2654435769u) >> 23) & (Capacity - 1);
+}
+
+const DelayLearner::Entry* DelayLearner::Find(const std::uint32_t key) const
+{
+	const size_t home(Home(key));
+	for (size_t probe = 0; probe < MaxProbe; ++probe)
+	{
+		const Entry& entry(_entries[(home + probe) & (Capacity - 1)]);
+		if (entry.key == key)
+		{
+			return &entry;
+		}
+		if (entry.key == 0)
+		{
+			break;
+		}
+	}
+	return nullptr;
+}
+
+DelayLearner::Entry& DelayLearner::Slot(const std::uint32_t key)
+{
+	const size_t home(Home(key));
+	Entry* victim(&_entries[home]);
+	for (size_t probe = 0; probe < MaxProbe; ++probe)
+	{
+		Entry& entry(_entries[(home + probe) & (Capacity - 1)]);
+		if (entry.key == key || entry.key == 0)
+		{
+			return entry;
+		}
+		if (entry.samples < victim->samples)
+		{
+			victim = &entry;
+		}
+	}
+	*victim = Entry{ 0, 0.0f, 0 };
+	return *victim;
+}
+
+double DelayLearner::DelayFor(const std::uint32_t key, const double fallback) const
+{
+	const Entry* entry(key != 0 ? Find(key) : nullptr);
+	if (!entry || entry->samples == 0)
+	{
+		return fallback;
+	}
+	// never learn past a few multiples of the configured guess
+	const double ceiling(std::max(3.0 * fallback, 1.0));
+	return std::clamp(static_cast<double>(entry->delay) * Margin, MinDelay, ceiling);
+}
+
+void DelayLearner::Update(const std::uint32_t key, const double observedSeconds)
+{
+	if (key == 0 || observedSeconds < 0.0)
+	{
+		return;
+	}
+	Entry& entry(Slot(key));
+	if (entry.samples == 0)
+	{
+		entry.key = key;
+		entry.delay = static_cast<float>(observedSeconds);
+	}
+	else
+	{
+		entry.delay = static_cast<float>(Alpha * observedSeconds + (1.0 - Alpha) * entry.delay);
+	}
+	entry.samples = entry.samples < std::numeric_limits<std::uint32_t>::max() ? entry.samples + 1 : entry.samples;
+	REL_DMESSAGE("Learned PauseDelay for 0x{:08x} now {:.3f} seconds after {} samples, observed {:.3f}",
+		key, entry.delay, entry.samples, observedSeconds);
+}
+
+bool DelayLearner::Load()
+{
+	std::ifstream input(_fileName, std::ios::in | std::ios::binary);
+	if (!input)
+	{
+		REL_MESSAGE("No learned PauseDelay data, start from PauseDelay");
+		return false;
+	}
+	std::uint32_t magic(0);
+	std::uint32_t version(0);
+	input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	input.read(reinterpret_cast<char*>(&version), sizeof(version));
+	if (!input || magic != FileMagic || version != FileVersion)
+	{
+		REL_WARNING("Learned PauseDelay data invalid, start from PauseDelay");
+		return false;
+	}
+	std::array<Entry, Capacity> entries{};
+	input.read(reinterpret_cast<char*>(entries.data()), sizeof(entries));
+	if (!input)
+	{
+		REL_WARNING("Learned PauseDelay data truncated, start from PauseDelay");
+		return false;
+	}
+	_entries = entries;
+	REL_MESSAGE("Loaded learned PauseDelay for {} destinations",
+		std::count_if(_entries.cbegin(), _entries.cend(), [](const Entry& entry) { return entry.key != 0; }));
+	return true;
+}
+
+bool DelayLearner::Save() const
+{
+	std::ofstream output(_fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output)
+	{
+		REL_WARNING("Cannot save learned PauseDelay data");
+		return false;
+	}
+	output.write(reinterpret_cast<const char*>(&FileMagic), sizeof(FileMagic));
+	output.write(reinterpret_cast<const char*>(&FileVersion), sizeof(FileVersion));
+	output.write(reinterpret_cast<const char*>(_entries.data()), sizeof(_entries));
+	return static_cast<bool>(output);
+}
+
+}
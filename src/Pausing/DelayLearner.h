@@ -0,0 +1,73 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+namespace palu
+{
+
+// Learned PauseDelay per load destination (interior CELL or exterior worldspace FormID). Each key keeps an EWMA of
+// observed time from Loading Menu close to player ready, in a compact fixed-capacity table persisted across sessions.
+// Not thread-safe - PauseController only touches it from the scheduler thread.
+class DelayLearner
+{
+public:
+	DelayLearner() = delete;
+	explicit DelayLearner(const std::filesystem::path& fileName);
+
+	// learned delay for this destination with safety margin, or fallback if never observed
+	[[nodiscard]] double DelayFor(const std::uint32_t key, const double fallback) const;
+	void Update(const std::uint32_t key, const double observedSeconds);
+
+	bool Load();
+	bool Save() const;
+
+private:
+	struct Entry
+	{
+		std::uint32_t key;	// 0 means empty
+		float delay;
+		std::uint32_t samples;
+	};
+	static_assert(sizeof(Entry) == 12);
+
+	static constexpr size_t Capacity = 512;
+	static_assert((Capacity & (Capacity - 1)) == 0, "table capacity must be a power of two");
+	static constexpr size_t MaxProbe = 16;
+	// weight of the newest observation
+	static constexpr double Alpha = 0.25;
+	static constexpr double Margin = 1.25;
+	static constexpr double MinDelay = 0.1;
+	static constexpr std::uint32_t FileMagic = 0x444c4150;	// 'PALD'
+	static constexpr std::uint32_t FileVersion = 1;
+
+	[[nodiscard]] const Entry* Find(const std::uint32_t key) const;
+	// existing entry for key, else an empty slot, else the least-sampled slot in the probe sequence
+	Entry& Slot(const std::uint32_t key);
+	static size_t Home(const std::uint32_t key);
+
+	std::array<Entry, Capacity> _entries{};
+	std::filesystem::path _fileName;
+};
+
+}
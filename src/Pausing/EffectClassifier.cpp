@@ -0,0 +1,81 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/EffectClassifier.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace palu
+{
+
+size_t EffectClassifier::Workers(const size_t count)
+{
+	if (count < MinFormsPerWorker * 2)
+	{
+		return 1;
+	}
+	return std::clamp<size_t>(std::min<size_t>(std::thread::hardware_concurrency(), count / MinFormsPerWorker), 1, MaxWorkers);
+}
+
+std::vector<RE::FormID> EffectClassifier::Classify(const std::span<RE::EffectSetting* const> forms, const PauseVetoRules& rules,
+	const size_t workers)
+{
+	const size_t count(forms.size());
+	const size_t chunk((count + std::max<size_t>(workers, 1) - 1) / std::max<size_t>(workers, 1));
+	const auto chunkOf([forms, count, chunk](const size_t worker) {
+		const size_t begin(std::min(count, worker * chunk));
+		return forms.subspan(begin, std::min(count, begin + chunk) - begin);
+	});
+	std::vector<std::vector<RE::FormID>> found(std::max<size_t>(workers, 1));
+	{
+		std::vector<std::jthread> pool;
+		for (size_t worker = 1; worker < found.size(); ++worker)
+		{
+			pool.emplace_back([&rules, &found, chunkOf, worker] { ClassifyChunk(chunkOf(worker), rules, found[worker]); });
+		}
+		ClassifyChunk(chunkOf(0), rules, found[0]);
+	}
+	std::vector<RE::FormID> vetoed;
+	for (const auto& buffer : found)
+	{
+		vetoed.insert(vetoed.end(), buffer.cbegin(), buffer.cend());
+	}
+	return vetoed;
+}
+
+// Save MGEF vetoed by the configured rules - by default Slow Time archetype and Value Modifier on Bow Speed Bonus.
+// Constant Effects skipped by default to avoid inoperable state.
+void EffectClassifier::ClassifyChunk(const std::span<RE::EffectSetting* const> forms, const PauseVetoRules& rules,
+	std::vector<RE::FormID>& vetoed)
+{
+	for (const RE::EffectSetting* effect : forms)
+	{
+		if (effect && rules.Vetoes(*effect))
+		{
+			REL_VMESSAGE("Pause veto Magic Effect : {}({:08x}) archetype {}", effect->GetName(), effect->GetFormID(),
+				static_cast<std::uint32_t>(effect->GetArchetype()));
+			vetoed.push_back(effect->GetFormID());
+		}
+	}
+}
+
+}
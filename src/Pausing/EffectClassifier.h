@@ -0,0 +1,55 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Pausing/PauseVetoRules.h"
+
+namespace palu
+{
+
+// Classifies the loaded Magic Effects against the PauseVetoRules at data load. The form array is split into contiguous
+// chunks, one per worker, and each worker classifies its chunk into its own buffer - the buffers are merged at the end,
+// so workers share nothing but the read-only rules and forms.
+class EffectClassifier
+{
+public:
+	EffectClassifier() = delete;
+
+	// below this many forms per worker, threads cost more than they save
+	static constexpr size_t MinFormsPerWorker = 4096;
+	static constexpr size_t MaxWorkers = 4;
+
+	// workers worth running for this many forms on this machine
+	[[nodiscard]] static size_t Workers(const size_t count);
+
+	// FormIDs of the vetoed effects, unsorted - the calling thread classifies the first chunk itself
+	[[nodiscard]] static std::vector<RE::FormID> Classify(const std::span<RE::EffectSetting* const> forms,
+		const PauseVetoRules& rules, const size_t workers);
+
+private:
+	static void ClassifyChunk(const std::span<RE::EffectSetting* const> forms, const PauseVetoRules& rules,
+		std::vector<RE::FormID>& vetoed);
+};
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace palu
+{
+
+// one condition that must hold before freezing is safe - evaluated on the game thread
+struct ReadinessProbe
+{
+	const char* name;
+	std::function<bool()> ready;
+};
+
+// Engine operations the pause decision logic depends on. PauseHandler implements these over the RE:: singletons,
+// which keeps PauseController free of game types so it can be driven without a running game.
+class GameEngine
+{
+public:
+	virtual ~GameEngine() = default;
+
+	// dialogue or an active slow-time effect makes freezing unsafe
+	[[nodiscard]] virtual bool CanFreeze() = 0;
+	// all controls-enabled checks pass, player has control after the load screen
+	[[nodiscard]] virtual bool ControlsReady() = 0;
+	// CELL setup has completed when all of these pass
+	[[nodiscard]] virtual const std::vector<ReadinessProbe>& ReadinessProbes() = 0;
+	// load destination - interior CELL or exterior worldspace FormID, 0 if unknown
+	[[nodiscard]] virtual std::uint32_t DestinationKey() = 0;
+	// pause or resume game time - game thread only
+	virtual void SetFreezeTime(const bool freeze) = 0;
+	// run the task once on the game thread, during the next rendered frame
+	virtual void QueueFrameTask(std::function<void()> task) = 0;
+	// listen for unpause input
+	virtual void EnableInput() = 0;
+	virtual void DisableInput() = 0;
+};
+
+}
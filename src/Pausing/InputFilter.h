@@ -0,0 +1,211 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+// unpause decision per input device and event type, snapshotted from SettingsCache when the listener is enabled so that
+// the per-event test is one bit lookup
+class InputFilter
+{
+public:
+	static constexpr size_t EventTypes = static_cast<size_t>(RE::INPUT_EVENT_TYPE::kNone);
+	static constexpr size_t Devices = static_cast<size_t>(RE::INPUT_DEVICE::kTotal);
+	static_assert(EventTypes * Devices <= 32, "InputFilter bitmask too small");
+
+	InputFilter() = default;
+
+	void Snapshot()
+	{
+		_restricted = 0;
+		for (size_t device = 0; device < SettingsCache::UnpauseKeyDevices; ++device)
+		{
+			_keys[device] = SettingsCache::Instance().UnpauseKeys(device);
+			if (_keys[device].any())
+			{
+				_restricted |= 1U << device;
+			}
+		}
+		std::uint32_t accepted(0);
+		for (size_t eventType = 0; eventType < EventTypes; ++eventType)
+		{
+			const bool ignored(IsIgnored(static_cast<RE::INPUT_EVENT_TYPE>(eventType)));
+			for (size_t device = 0; device < Devices; ++device)
+			{
+				const bool restricted((_restricted & (1U << device)) != 0);
+				bool accepts(!ignored);
+				if (eventType == static_cast<size_t>(RE::INPUT_EVENT_TYPE::kButton))
+				{
+					// a configured key list decides for that device's buttons
+					accepts = accepts || restricted;
+				}
+				else if (eventType == static_cast<size_t>(RE::INPUT_EVENT_TYPE::kChar))
+				{
+					// the character a key press types follows its button - it carries no IDCode to match a key list
+					accepts = accepts && !restricted;
+				}
+				if (accepts)
+				{
+					accepted |= 1U << Bit(device, eventType);
+				}
+			}
+		}
+		_accepted = accepted;
+		DBG_MESSAGE("Input filter accepts 0x{:08x}", _accepted);
+	}
+
+	// unknown device or event type never unpauses
+	[[nodiscard]] bool Accepts(const RE::InputEvent& event) const
+	{
+		const size_t deviceIndex(static_cast<size_t>(event.GetDevice()));
+		const size_t eventIndex(static_cast<size_t>(event.GetEventType()));
+		if (deviceIndex >= Devices || eventIndex >= EventTypes || (_accepted & (1U << Bit(deviceIndex, eventIndex))) == 0)
+		{
+			return false;
+		}
+		if (event.GetEventType() != RE::INPUT_EVENT_TYPE::kButton || (_restricted & (1U << deviceIndex)) == 0)
+		{
+			return true;
+		}
+		// configured unpause keys - one bit test however many are listed
+		const std::uint32_t idCode(event.AsButtonEvent()->GetIDCode());
+		return idCode < _keys[deviceIndex].size() && _keys[deviceIndex].test(idCode);
+	}
+
+private:
+	static bool IsIgnored(const RE::INPUT_EVENT_TYPE eventType)
+	{
+		switch (eventType)
+		{
+		case RE::INPUT_EVENT_TYPE::kButton:
+		case RE::INPUT_EVENT_TYPE::kChar:
+			return SettingsCache::Instance().IgnoreKeyPressAndButton();
+		case RE::INPUT_EVENT_TYPE::kMouseMove:
+			return SettingsCache::Instance().IgnoreMouseMove();
+		case RE::INPUT_EVENT_TYPE::kThumbstick:
+			return SettingsCache::Instance().IgnoreThumbstick();
+		// plugging in a controller is not a request to unpause
+		case RE::INPUT_EVENT_TYPE::kDeviceConnect:
+		case RE::INPUT_EVENT_TYPE::kKinect:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static constexpr size_t Bit(const size_t device, const size_t eventType)
+	{
+		return device * EventTypes + eventType;
+	}
+
+	std::uint32_t _accepted = 0;
+	// devices with a configured key list, and the lists themselves
+	std::uint32_t _restricted = 0;
+	std::array<SettingsCache::UnpauseKeySet, SettingsCache::UnpauseKeyDevices> _keys;
+};
+
+// Magnitude threshold and minimum-duration debounce for analog input, so a drifting stick or a nudged mouse does not
+// unpause. Events below threshold are rejected with a few arithmetic ops, and the clock is only read for events above
+// threshold when a duration is configured. Input thread only, after Snapshot.
+class AnalogFilter
+{
+public:
+	AnalogFilter() = default;
+
+	void Snapshot()
+	{
+		const double thumbstick(SettingsCache::Instance().ThumbstickUnpauseThreshold());
+		const double mouseMove(SettingsCache::Instance().MouseMoveUnpauseThreshold());
+		_thumbstickThresholdSquared = static_cast<float>(thumbstick * thumbstick);
+		_mouseMoveThresholdSquared = static_cast<std::int64_t>(mouseMove * mouseMove);
+		_minDuration = std::chrono::duration_cast<PluginClock::duration>(
+			std::chrono::duration<double>(SettingsCache::Instance().AnalogUnpauseDuration()));
+		_aboveSince.fill({});
+		_lastAbove.fill({});
+	}
+
+	[[nodiscard]] bool Passes(const RE::InputEvent& event)
+	{
+		switch (event.GetEventType())
+		{
+		case RE::INPUT_EVENT_TYPE::kThumbstick:
+		{
+			const RE::ThumbstickEvent& thumbstick(static_cast<const RE::ThumbstickEvent&>(event));
+			const float squared(thumbstick.xValue * thumbstick.xValue + thumbstick.yValue * thumbstick.yValue);
+			return Debounce(Thumbstick, squared >= _thumbstickThresholdSquared);
+		}
+		case RE::INPUT_EVENT_TYPE::kMouseMove:
+		{
+			const RE::MouseMoveEvent& mouseMove(static_cast<const RE::MouseMoveEvent&>(event));
+			const std::int64_t x(mouseMove.mouseInputX);
+			const std::int64_t y(mouseMove.mouseInputY);
+			return Debounce(MouseMove, x * x + y * y >= _mouseMoveThresholdSquared);
+		}
+		default:
+			return true;
+		}
+	}
+
+private:
+	enum Axis : size_t
+	{
+		Thumbstick = 0,
+		MouseMove,
+		MaxAxis
+	};
+
+	bool Debounce(const Axis axis, const bool above)
+	{
+		if (!above)
+		{
+			_aboveSince[axis] = {};
+			return false;
+		}
+		if (_minDuration.count() <= 0)
+		{
+			return true;
+		}
+		const auto now(PluginClock::now());
+		// mouse stops sending when still - a gap means the movement was not sustained
+		if (_aboveSince[axis] == PluginClock::time_point() || now - _lastAbove[axis] > MaxGap)
+		{
+			_aboveSince[axis] = now;
+		}
+		_lastAbove[axis] = now;
+		return now - _aboveSince[axis] >= _minDuration;
+	}
+
+	static constexpr std::chrono::milliseconds MaxGap{ 100 };
+
+	float _thumbstickThresholdSquared = 0.0f;
+	std::int64_t _mouseMoveThresholdSquared = 0;
+	PluginClock::duration _minDuration{ 0 };
+	std::array<PluginClock::time_point, MaxAxis> _aboveSince{};
+	std::array<PluginClock::time_point, MaxAxis> _lastAbove{};
+};
+
+}
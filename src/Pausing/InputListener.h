@@ -19,6 +19,10 @@ http://www.fsf.org/licensing/licenses
 >>> END OF LICENSE >>>
 *************************************************************************/
 
+#include "Pausing/InputFilter.h"
+#include "Pausing/InputStats.h"
+#include "Pausing/PauseTimeline.h"
+
 namespace palu
 {
 
@@ -27,95 +31,162 @@ class InputHandler
 {
 public:
 	InputHandler() = default;
-	void operator()(RE::InputEvent* const& a_event, std::function<void(void)> resultHandler)
+	// returns true if the event unpaused the game
+	template <typename ResultHandler>
+	bool operator()(RE::InputEvent* const& a_event, const ResultHandler& resultHandler)
 	{
 		if (a_event)
 		{
-			auto eventType(a_event->GetEventType());
-			if ((eventType == RE::INPUT_EVENT_TYPE::kButton && SettingsCache::Instance().IgnoreKeyPressAndButton()) ||
-				(eventType == RE::INPUT_EVENT_TYPE::kMouseMove && SettingsCache::Instance().IgnoreMouseMove()) ||
-				(eventType == RE::INPUT_EVENT_TYPE::kThumbstick && SettingsCache::Instance().IgnoreThumbstick()))
+			const bool accepted(_filter.Accepts(*a_event) && _analog.Passes(*a_event));
+			_stats.Record(a_event->GetDevice(), a_event->GetEventType(), accepted);
+			if (!accepted)
 			{
-				return;
+				return false;
 			}
 			REL_MESSAGE("Pause terminated by Input Event type {} from Device {}",
 				a_event->eventType.underlying(), a_event->device.underlying());
 			resultHandler();
+			return true;
 		}
+		return false;
 	}
+
+	// refresh the filter from current settings, and restart input stats
+	void Prepare()
+	{
+		_filter.Snapshot();
+		_analog.Snapshot();
+		_stats.Start();
+	}
+
+	void Report() const
+	{
+		_stats.Report();
+	}
+
+private:
+	InputFilter _filter;
+	AnalogFilter _analog;
+	InputStats _stats;
 };
 
+// ResultHandler is held by value and invoked in place - no allocation or copy on the input thread
+template <typename ResultHandler>
 class InputListener :
 	public RE::BSTEventSink<RE::InputEvent*>
 {
+	static_assert(std::is_trivially_copyable_v<ResultHandler>, "ResultHandler must not own state");
+	static_assert(std::is_invocable_v<const ResultHandler&>, "ResultHandler must be callable with no arguments");
+
 public:
 	InputListener() = delete;
-	InputListener(std::function<void(void)> resultHandler)
+	InputListener(const ResultHandler& resultHandler, const bool persistent) : _resultHandler(resultHandler), _persistent(persistent)
 	{
-		_resultHandler = resultHandler;
-		_callback = std::make_unique<InputHandler>();
+		if (_persistent)
+		{
+			AddSink();
+		}
 	}
 
-	InputListener(const InputListener&) = default;
-	InputListener(InputListener&&) = default;
+	InputListener(const InputListener&) = delete;
+	InputListener(InputListener&&) = delete;
 
-	~InputListener() { Disable(); }
+	~InputListener() { RemoveSink(); }
 
-	InputListener& operator=(const InputListener&) = default;
-	InputListener& operator=(InputListener&&) = default;
+	InputListener& operator=(const InputListener&) = delete;
+	InputListener& operator=(InputListener&&) = delete;
 
 	void Enable()
+	{
+		// a listener left enabled must not be reading the filter while it is rewritten
+		_enabled.store(false, std::memory_order_relaxed);
+		WaitForDispatch();
+		_callback.Prepare();
+		_profile = SettingsCache::Instance().ProfileInput();
+		// release publishes the filter snapshot to the input thread
+		_enabled.store(true, std::memory_order_release);
+		if (!_persistent)
+		{
+			AddSink();
+		}
+	}
+
+	void Disable()
+	{
+		// pause ended, or a new CanUnpauseAfter window started
+		if (_enabled.exchange(false, std::memory_order_relaxed))
+		{
+			_callback.Report();
+		}
+		if (!_persistent)
+		{
+			RemoveSink();
+		}
+	}
+
+private:
+	// the event source holds its lock while it dispatches - once we have held it, no event is in flight and any later
+	// dispatch sees _enabled false
+	void WaitForDispatch()
 	{
 		auto input = RE::BSInputDeviceManager::GetSingleton();
 		if (input) {
-			input->AddEventSink(this);
+			RE::BSSpinLockGuard dispatching(input->lock);
 		}
 	}
 
-	void SetDelay(const double ignoreInput)
+	// both take the event source's lock and rewrite its sink array
+	void AddSink()
 	{
-		_delayUnpause = ignoreInput > 0.0;
-		if (_delayUnpause)
-		{
-			_delayExpiry = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(static_cast<long long>(ignoreInput * 1000.0));
+		auto input = RE::BSInputDeviceManager::GetSingleton();
+		if (input) {
+			input->AddEventSink(this);
+			PauseTimeline::Instance().RecordInputSinkChange();
 		}
 	}
 
-	void Disable()
+	void RemoveSink()
 	{
 		auto input = RE::BSInputDeviceManager::GetSingleton();
 		if (input) {
 			input->RemoveEventSink(this);
+			PauseTimeline::Instance().RecordInputSinkChange();
 		}
 	}
 
-private:
 	RE::BSEventNotifyControl ProcessEvent(RE::InputEvent* const* a_event, RE::BSTEventSource<RE::InputEvent*>*) override
 	{
-		if (a_event && *a_event) {
-			if (_delayUnpause)
+		// enabled only once any CanUnpauseAfter window has expired, so every event here is eligible
+		// acquire costs nothing extra on x64, and pairs with the filter snapshot published by Enable
+		if (_enabled.load(std::memory_order_acquire) && a_event && *a_event) {
+			const auto started(_profile ? PluginClock::now() : PluginClock::time_point());
+			// the engine delivers a chain per poll - a qualifying event may follow filtered ones
+			std::uint64_t examined(0);
+			for (RE::InputEvent* event = *a_event; event; event = event->next)
 			{
-				const std::chrono::milliseconds timeAfterExpiry(
-					std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - _delayExpiry));
-				if (timeAfterExpiry.count() > 0)
+				++examined;
+				if (_callback(event, _resultHandler))
 				{
-					_delayUnpause = false;
-					REL_MESSAGE("CanUnpauseAfter timer expired {} milliseconds ago", timeAfterExpiry.count());
+					break;
 				}
 			}
-			if (!_delayUnpause)
+			PauseTimeline::Instance().RecordInputBatch(examined);
+			if (_profile)
 			{
-				(*_callback)(*a_event, _resultHandler);
+				PauseTimeline::Instance().RecordInputDispatch(static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(PluginClock::now() - started).count()), examined);
 			}
 		}
 
 		return RE::BSEventNotifyControl::kContinue;
 	}
 
-	std::unique_ptr<InputHandler> _callback;
-	std::function<void(void)> _resultHandler;
-	std::chrono::time_point<std::chrono::high_resolution_clock> _delayExpiry;
-	bool _delayUnpause{ false };
+	InputHandler _callback;
+	ResultHandler _resultHandler;
+	std::atomic<bool> _enabled{ false };
+	// snapshotted by Enable, published with the filter
+	bool _profile{ false };
+	bool _persistent;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Pausing/InputFilter.h"
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+// Input events seen while listening, per device and event type, split into filtered and accepted. Relaxed atomic
+// increments only on the input thread, cheap enough to leave on in release builds.
+class InputStats
+{
+public:
+	InputStats() = default;
+
+	// start counting afresh when the listener is enabled
+	void Start()
+	{
+		for (auto& device : _counts)
+		{
+			for (auto& eventType : device)
+			{
+				for (auto& count : eventType)
+				{
+					count.store(0, std::memory_order_relaxed);
+				}
+			}
+		}
+		_started = PluginClock::now();
+	}
+
+	void Record(const RE::INPUT_DEVICE device, const RE::INPUT_EVENT_TYPE eventType, const bool accepted)
+	{
+		const size_t deviceIndex(static_cast<size_t>(device));
+		const size_t eventIndex(static_cast<size_t>(eventType));
+		if (deviceIndex < InputFilter::Devices && eventIndex < InputFilter::EventTypes)
+		{
+			_counts[deviceIndex][eventIndex][accepted ? 1 : 0].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// log event rates per device since Start, to show what ended or tried to end the pause
+	void Report() const
+	{
+		const double seconds(std::max(
+			std::chrono::duration<double>(PluginClock::now() - _started).count(), 0.001));
+		for (size_t device = 0; device < InputFilter::Devices; ++device)
+		{
+			std::uint64_t total(0);
+			for (const auto& eventType : _counts[device])
+			{
+				total += eventType[0].load(std::memory_order_relaxed) + eventType[1].load(std::memory_order_relaxed);
+			}
+			if (total == 0)
+			{
+				continue;
+			}
+			REL_MESSAGE("Input from {} while paused: {} events in {:.1f} seconds, {:.1f} per second",
+				DeviceNames[device], total, seconds, static_cast<double>(total) / seconds);
+			for (size_t eventType = 0; eventType < InputFilter::EventTypes; ++eventType)
+			{
+				const std::uint32_t filtered(_counts[device][eventType][0].load(std::memory_order_relaxed));
+				const std::uint32_t accepted(_counts[device][eventType][1].load(std::memory_order_relaxed));
+				if (filtered + accepted > 0)
+				{
+					REL_MESSAGE("  {} filtered {} accepted {}", EventTypeNames[eventType], filtered, accepted);
+				}
+			}
+		}
+	}
+
+private:
+	static constexpr std::array<const char*, InputFilter::Devices> DeviceNames = {
+		"Keyboard", "Mouse", "Gamepad", "VirtualKeyboard"
+	};
+	static constexpr std::array<const char*, InputFilter::EventTypes> EventTypeNames = {
+		"Button", "MouseMove", "Char", "Thumbstick", "DeviceConnect", "Kinect"
+	};
+
+	std::array<std::array<std::array<std::atomic<std::uint32_t>, 2>, InputFilter::EventTypes>, InputFilter::Devices> _counts{};
+	PluginClock::time_point _started;
+};
+
+}
@@ -0,0 +1,624 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+// Pause logic per wsPauseQuestAliasScript.psc, courtesy of wskeever and bobbyclue
+#include <boost/asio.hpp>
+#include <chrono>
+#include <optional>
+
+#include "Pausing/DelayLearner.h"
+#include "Pausing/GameEngine.h"
+#include "Pausing/PauseLeases.h"
+#include "Pausing/PauseState.h"
+#include "Pausing/PauseTimeline.h"
+#include "Pausing/Scheduler.h"
+#include "Utilities/PluginClock.h"
+#include "Data/SettingsCache.h"
+
+namespace palu
+{
+
+// Pause decisions and timing, independent of RE:: types - game access goes through GameEngine
+class PauseController
+{
+public:
+	PauseController() = delete;
+	PauseController(const PauseController&) = delete;
+	PauseController(PauseController&&) = delete;
+
+	PauseController(GameEngine& engine, const std::filesystem::path& learnedDelays) :
+		_engine(engine), _learner(learnedDelays), _scheduler(), _timer(_scheduler.Context()), _pauseDelayTimer(_scheduler.Context()),
+		_inputTimer(_scheduler.Context())
+	{
+	}
+
+	PauseController& operator=(const PauseController&) = delete;
+	PauseController& operator=(PauseController&&) = delete;
+
+	// no further timer or unpause jobs may touch the engine after this
+	void Stop()
+	{
+		_scheduler.Stop();
+	}
+
+	// set when game loading message is detected, to distinguish fast-travel and door transition from game load
+	void SetIsLoading()
+	{
+		_state.SetLoading();
+	}
+
+	[[nodiscard]] PauseState State() const { return _state.State(); }
+
+#if defined(PALU_VIRTUAL_CLOCK)
+	// off-game harness only - runs the lifecycle on virtual time
+	Scheduler& GetScheduler() { return _scheduler; }
+#endif
+
+	bool StartPause(const bool isSaving = false)
+	{
+		// Skip pause if config demands it - cases are saving/loading/load-screen
+		PauseReason reason(PauseReason::Save);
+		if (!isSaving)
+		{
+			if (_state.ConsumeLoading())
+			{
+				DBG_MESSAGE("Called on game load");
+				reason = PauseReason::GameLoad;
+				if (!SettingsCache::Instance().PauseOnLoad())
+				{
+					return false;
+				}
+			}
+			else
+			{
+				DBG_MESSAGE("Called on load-screen, not game load");
+				reason = PauseReason::LoadScreen;
+				if (!SettingsCache::Instance().PauseOnLoadScreen())
+				{
+					return false;
+				}
+			}
+		}
+		else
+		{
+			DBG_MESSAGE("Called on game save");
+		}
+
+		// Check for known crashes, and if player is in Slow Time then do not pause
+		if (!_engine.CanFreeze())
+		{
+			return false;
+		}
+		const auto armed(_state.Transition(PauseState::Armed));
+		if (!armed)
+		{
+			if (_state.State() == PauseState::Frozen)
+			{
+				// overlapping trigger - keep the game frozen until this one's lease expires too
+				REL_MESSAGE("Already frozen, add {} pause lease", PauseReasonName(reason));
+				const std::uint32_t generation(_state.Generation());
+				_scheduler.Post([this, reason, generation] { AcquireLease(reason, generation); });
+				return true;
+			}
+			REL_WARNING("Already paused in state {}, ignore new request", PauseStateName(_state.State()));
+			return false;
+		}
+		const std::uint32_t generation(armed->generation);
+		if (armed->from == PauseState::Delaying)
+		{
+			// new load arrived before the previous pause froze time - take over that pause
+			REL_MESSAGE("Cancel pending PauseDelay, pause restarts after this load");
+			_scheduler.Post([this, reason, generation] {
+				CancelLifecycle();
+				AcquireLease(reason, generation);
+			});
+		}
+		else
+		{
+			REL_MESSAGE("OK to freeze time");
+			_scheduler.Post([this, reason, generation] {
+				// nothing from an earlier pause cycle may hold this one
+				_leases.ReleaseAll();
+				AcquireLease(reason, generation);
+			});
+		}
+		return true;
+	}
+
+	void ProgressPause()
+	{
+		if (_state.State() == PauseState::Frozen)
+		{
+			// an overlapping trigger's pause has progressed - start its lease clock and stay frozen
+			const std::uint32_t generation(_state.Generation());
+			_scheduler.Post([this, generation] { ActivateLeases(generation); });
+			return;
+		}
+		if (_state.State() != PauseState::Armed)
+		{
+			REL_WARNING("Pause not armed, state {}", PauseStateName(_state.State()));
+			return;
+		}
+		const unsigned int freezeAfterFrames(SettingsCache::Instance().FreezeAfterFrames());
+		const bool freezeWhenReady(freezeAfterFrames == 0 && SettingsCache::Instance().FreezeWhenReady());
+		// check controls state - readiness probes poll this themselves
+		if (!freezeWhenReady && !_engine.ControlsReady())
+		{
+			_scheduler.Post([this] { ResumeGame(); });
+			return;
+		}
+		const auto delaying(_state.Transition(PauseState::Delaying));
+		if (!delaying)
+		{
+			REL_WARNING("Pause ended before it could progress, state {}", PauseStateName(_state.State()));
+			return;
+		}
+		// Optionally, resume after configured delay. Delay, freeze and timeout run as one coroutine on the scheduler thread.
+		// delay pause for CELL setup, if configured
+		const double pauseDelay(SettingsCache::Instance().PauseDelay());
+		// learn only for the wall-clock delay, and never delay a pause the user wants immediate
+		const std::uint32_t destination(SettingsCache::Instance().AdaptivePauseDelay() && freezeAfterFrames == 0 &&
+			!freezeWhenReady && pauseDelay > 0.0 ? _engine.DestinationKey() : 0);
+		// Input Listener is registered once any configured CanUnpauseAfter delay expires
+		const double ignoreInput(SettingsCache::Instance().CanUnpauseAfter());
+		const LifecyclePlan plan{ delaying->generation, pauseDelay, ignoreInput, freezeAfterFrames, freezeWhenReady, destination,
+			PluginClock::now() };
+		PauseTimeline::Instance().Record(PausePhase::PauseProgressed, plan.generation);
+		DBG_MESSAGE("Scheduler threads created {}", Scheduler::ThreadsCreated());
+		_scheduler.Post([this, plan] {
+			boost::asio::co_spawn(_scheduler.Context(), PauseLifecycle(plan), boost::asio::detached);
+		});
+	}
+
+	// menu handling - on the first pass after launch, we do not get a menu-opened event and should not pause
+	// on menu-closed event, so we use the menu-opened event to prime the menu-closed event
+	void OnLoadingMenuOpened()
+	{
+		// set the stage for Pause when the corresponding menu-closed arrives
+		const bool canPause(StartPause());
+		// after arming, so the event belongs to the pause cycle it starts
+		PauseTimeline::Instance().Record(PausePhase::LoadingMenuOpened, _state.Generation());
+		REL_MESSAGE("Loading Menu opened - pause OK {}", canPause);
+	}
+
+	void OnLoadingMenuClosed()
+	{
+		PauseTimeline::Instance().Record(PausePhase::LoadingMenuClosed, _state.Generation());
+		// skip ProgressPause() if this is first pass after process launch - if already frozen, this starts the lease clock
+		// for the load screen that just closed
+		if (_state.State() == PauseState::Armed || _state.State() == PauseState::Frozen)
+		{
+			// Loading Menu closed - need to pause
+			REL_MESSAGE("Loading Menu closed after preceding Opened event - pause OK");
+			ProgressPause();
+		}
+		else
+		{
+			REL_MESSAGE("Loading Menu closed without preceding Opened event - no pause");
+		}
+	}
+
+	// may be called from input or game thread - the game is resumed on the scheduler thread, in order after any pending freeze
+	void Unpause()
+	{
+		PauseTimeline::Instance().Record(PausePhase::InputReceived, _state.Generation());
+		_scheduler.Post([this] {
+			if (_lifecycleGeneration != 0 && _lifecycleGeneration == _state.Generation())
+			{
+				// the running lifecycle resumes the game when it wakes
+				_inputReceived = true;
+				_pauseDelayTimer.cancel();
+				_timer.cancel();
+			}
+			else
+			{
+				ResumeGame();
+			}
+		});
+	}
+
+private:
+	// everything a pause lifecycle needs, captured when the pause progresses
+	struct LifecyclePlan
+	{
+		std::uint32_t generation;
+		double pauseDelay;
+		double ignoreInput;
+		unsigned int freezeAfterFrames;
+		bool freezeWhenReady;
+		std::uint32_t destination;
+		PluginClock::time_point closedAt;
+	};
+
+	// runs on scheduler thread - generation is supplied by the lifecycle, which only ends the pause cycle it belongs to
+	void ResumeGame(const std::optional<std::uint32_t> generation = std::nullopt)
+	{
+		if (_state.Transition(PauseState::Resuming, generation))
+		{
+			CancelLifecycle();
+			REL_DMESSAGE("Restart game");
+			// Resume game - queued behind any pending freeze, so the game thread writes the flag in order
+			_engine.QueueFrameTask([this] { _engine.SetFreezeTime(false); });
+			_leases.ReleaseAll();
+			_state.Transition(PauseState::Idle);
+			PauseTimeline::Instance().Record(PausePhase::Resumed, _state.Generation());
+			if (SettingsCache::Instance().DumpTimeline())
+			{
+				PauseTimeline::Instance().Dump();
+			}
+		}
+		else
+		{
+			REL_WARNING("Already unpaused in state {}, ignore new request, {} illegal transitions",
+				PauseStateName(_state.State()), _state.IllegalTransitions());
+		}
+	}
+
+	// runs on scheduler thread
+	void AcquireLease(const PauseReason reason, const std::uint32_t generation)
+	{
+		// the pause this trigger joined may already have ended
+		if (_state.Generation() != generation || _state.State() == PauseState::Idle || _state.State() == PauseState::Resuming)
+		{
+			REL_DMESSAGE("Pause cycle ended before {} lease was taken", PauseReasonName(reason));
+			return;
+		}
+		REL_DMESSAGE("Acquire {} pause lease", PauseReasonName(reason));
+		_leases.Acquire(reason);
+		// a pending lease holds the pause until its own pause progresses - wake the lifecycle to recompute its timeout
+		_timer.cancel();
+	}
+
+	// runs on scheduler thread - start the ResumeAfter clock for leases whose pause has progressed
+	void ActivateLeases(const std::uint32_t generation)
+	{
+		if (_state.Generation() != generation)
+		{
+			return;
+		}
+		const double delay(SettingsCache::Instance().ResumeAfter());
+		const double ignoreInput(SettingsCache::Instance().CanUnpauseAfter());
+		std::optional<PauseLeases::Clock::time_point> expiry;
+		if (delay > 0.0)
+		{
+			REL_DMESSAGE("Resume game if no input for {:.1f} seconds, ignoring input for {:.1f} seconds", delay, ignoreInput);
+			expiry = PauseLeases::Clock::now() + std::chrono::milliseconds(static_cast<long long>((delay + ignoreInput) * 1000.0));
+		}
+		_leases.Activate(expiry);
+		_timer.cancel();
+	}
+
+	// runs on scheduler thread - the one place a running lifecycle is cancelled. Every await in the lifecycle wakes, and
+	// finds its generation cancelled or superseded. Input stops too, so that a pause taken over by a new load is not ended
+	// by a keypress during that load screen.
+	void CancelLifecycle()
+	{
+		_engine.DisableInput();
+		_cancelledGeneration = _lifecycleGeneration;
+		_pauseDelayTimer.cancel();
+		_timer.cancel();
+		_inputTimer.cancel();
+	}
+
+	// runs on scheduler thread
+	[[nodiscard]] bool LifecycleActive(const std::uint32_t generation) const
+	{
+		return _lifecycleGeneration == generation && _cancelledGeneration != generation && _state.Generation() == generation;
+	}
+
+	// runs on scheduler thread, after every wake in the delay stages - input received during the delay ends the pause
+	bool StillDelaying(const std::uint32_t generation)
+	{
+		if (!LifecycleActive(generation))
+		{
+			REL_DMESSAGE("Pause lifecycle cancelled, state {}", PauseStateName(_state.State()));
+			return false;
+		}
+		if (_inputReceived)
+		{
+			ResumeGame(generation);
+			return false;
+		}
+		return true;
+	}
+
+	// Pause lifecycle, one coroutine per pause cycle on the scheduler thread: delay, freeze, then whichever comes first
+	// of input or lease timeout. Nothing blocks while it waits, new stages slot in as another co_await.
+	boost::asio::awaitable<void> PauseLifecycle(const LifecyclePlan plan)
+	{
+		_lifecycleGeneration = plan.generation;
+		_inputReceived = false;
+		ActivateLeases(plan.generation);
+		boost::asio::co_spawn(_scheduler.Context(), AcceptInputAfter(plan), boost::asio::detached);
+		bool frozen(false);
+		if (plan.freezeAfterFrames > 0)
+		{
+			frozen = co_await FreezeAfterFrames(plan);
+		}
+		else if (plan.freezeWhenReady)
+		{
+			frozen = co_await FreezeWhenReady(plan);
+		}
+		else
+		{
+			frozen = co_await FreezeAfterDelay(plan);
+		}
+		if (frozen)
+		{
+			co_await HoldUntilInputOrTimeout(plan.generation);
+		}
+		if (_lifecycleGeneration == plan.generation)
+		{
+			_lifecycleGeneration = 0;
+		}
+	}
+
+	// runs on scheduler thread - the CanUnpauseAfter window is implemented by deferring listener registration, so the input
+	// thread sees no events at all until input is allowed
+	boost::asio::awaitable<void> AcceptInputAfter(const LifecyclePlan plan)
+	{
+		if (plan.ignoreInput > 0.0)
+		{
+			// input stays off through the window - CancelLifecycle turned it off for a pause taken over from an earlier load
+			_inputTimer.expires_after(std::chrono::milliseconds(static_cast<long long>(plan.ignoreInput * 1000.0)));
+			boost::system::error_code ec;
+			co_await _inputTimer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+			if (ec)
+			{
+				co_return;
+			}
+			REL_MESSAGE("CanUnpauseAfter timer expired after {:.1f} seconds", plan.ignoreInput);
+		}
+		if (LifecycleActive(plan.generation))
+		{
+			_engine.EnableInput();
+		}
+	}
+
+	// runs on scheduler thread - PauseDelay is a cancellable deadline, learned per destination if configured
+	boost::asio::awaitable<bool> FreezeAfterDelay(const LifecyclePlan plan)
+	{
+		double pauseDelay(plan.pauseDelay);
+		if (plan.destination != 0)
+		{
+			pauseDelay = _learner.DelayFor(plan.destination, plan.pauseDelay);
+			REL_MESSAGE("Use PauseDelay {:.2f} seconds for destination 0x{:08x}", pauseDelay, plan.destination);
+			boost::asio::co_spawn(_scheduler.Context(), ObserveReadiness(plan, pauseDelay), boost::asio::detached);
+		}
+		if (pauseDelay > 0.0)
+		{
+			REL_MESSAGE("Delay for {:.1f} seconds", pauseDelay);
+			_pauseDelayTimer.expires_after(std::chrono::milliseconds(static_cast<long long>(pauseDelay * 1000.0)));
+			boost::system::error_code ec;
+			co_await _pauseDelayTimer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+			if (!StillDelaying(plan.generation))
+			{
+				co_return false;
+			}
+		}
+		co_return co_await OnGameThread([this, plan] { return Freeze(plan.generation); });
+	}
+
+	// runs on scheduler thread - counts rendered frames on the game thread, then freezes between frames from the last
+	// frame's task
+	boost::asio::awaitable<bool> FreezeAfterFrames(const LifecyclePlan plan)
+	{
+		REL_MESSAGE("Delay for {} frames", plan.freezeAfterFrames);
+		for (unsigned int frame = 1; frame < plan.freezeAfterFrames; ++frame)
+		{
+			co_await OnGameThread([] { return true; });
+			if (!StillDelaying(plan.generation))
+			{
+				REL_DMESSAGE("Frame countdown abandoned with {} frames left", plan.freezeAfterFrames - frame);
+				co_return false;
+			}
+		}
+		co_return co_await OnGameThread([this, plan] { return Freeze(plan.generation); });
+	}
+
+	// runs on scheduler thread - probes run on the game thread, backoff between polls is timed here
+	boost::asio::awaitable<bool> FreezeWhenReady(const LifecyclePlan plan)
+	{
+		REL_MESSAGE("Delay until readiness probes pass");
+		std::chrono::milliseconds interval(InitialProbeInterval);
+		while (true)
+		{
+			// freeze in the frame where the probes pass, before the game thread moves on
+			const bool frozen(co_await OnGameThread([this, plan] {
+				return EvaluateProbes(plan.closedAt, plan.generation) && Freeze(plan.generation);
+			}));
+			const auto elapsed(std::chrono::duration_cast<std::chrono::milliseconds>(PluginClock::now() - plan.closedAt));
+			if (frozen)
+			{
+				REL_MESSAGE("Readiness probes all passed {} milliseconds after Loading Menu closed", elapsed.count());
+				co_return true;
+			}
+			if (!StillDelaying(plan.generation))
+			{
+				co_return false;
+			}
+			if (elapsed >= MaxReadinessWait)
+			{
+				// same outcome as controls not enabled at Loading Menu close
+				REL_WARNING("Readiness probes not all passed after {} milliseconds, abandon pause", elapsed.count());
+				ResumeGame(plan.generation);
+				co_return false;
+			}
+			// shares the PauseDelay timer so that unpause or a new load cancels polling too
+			_pauseDelayTimer.expires_after(interval);
+			boost::system::error_code ec;
+			co_await _pauseDelayTimer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+			if (!StillDelaying(plan.generation))
+			{
+				co_return false;
+			}
+			interval = std::min(interval * 2, MaxProbeInterval);
+		}
+	}
+
+	// runs on scheduler thread - first of input or expiry of the last live lease. The wait tracks the latest expiry, lease
+	// changes and input wake it to look again.
+	boost::asio::awaitable<void> HoldUntilInputOrTimeout(const std::uint32_t generation)
+	{
+		while (LifecycleActive(generation))
+		{
+			if (_inputReceived)
+			{
+				ResumeGame(generation);
+				co_return;
+			}
+			_timer.expires_at(_leases.LatestExpiry().value_or(PauseLeases::Clock::time_point::max()));
+			boost::system::error_code ec;
+			co_await _timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+			if (ec)
+			{
+				continue;
+			}
+			if (_leases.ReleaseExpired(PauseLeases::Clock::now()))
+			{
+				REL_DMESSAGE("Pause still held by live lease");
+				continue;
+			}
+			REL_DMESSAGE("Pause timed out");
+			PauseTimeline::Instance().Record(PausePhase::TimedOut, generation);
+			ResumeGame(generation);
+		}
+	}
+
+	// runs on scheduler thread, once per rendered frame until the player is ready or the delay ends - independent of the
+	// lifecycle, which it must not hold up
+	boost::asio::awaitable<void> ObserveReadiness(const LifecyclePlan plan, const double delayUsed)
+	{
+		while (true)
+		{
+			const bool ready(co_await OnGameThread([this, plan] { return EvaluateProbes(plan.closedAt, plan.generation); }));
+			if (_state.Generation() != plan.generation)
+			{
+				co_return;
+			}
+			double observed(std::chrono::duration<double>(PluginClock::now() - plan.closedAt).count());
+			const PauseState state(_state.State());
+			if (state == PauseState::Delaying)
+			{
+				if (!ready)
+				{
+					continue;
+				}
+			}
+			else if (state == PauseState::Frozen)
+			{
+				// frozen before CELL setup completed - learned delay was too short, push it up
+				if (!ready)
+				{
+					observed = std::max(observed, delayUsed * UnderrunGrowth);
+				}
+			}
+			else
+			{
+				// pause ended by input or error, no valid observation
+				co_return;
+			}
+			_learner.Update(plan.destination, observed);
+			_learner.Save();
+			co_return;
+		}
+	}
+
+	// completes on the scheduler thread with the result of task, run on the game thread during the next rendered frame
+	boost::asio::awaitable<bool> OnGameThread(std::function<bool()> task)
+	{
+		co_return co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, void(bool)>(
+			[this](auto handler, std::function<bool()> task) {
+				// frame tasks must be copyable, the completion handler is move-only
+				auto shared(std::make_shared<decltype(handler)>(std::move(handler)));
+				_engine.QueueFrameTask([this, shared, task = std::move(task)] {
+					const bool result(task());
+					boost::asio::post(_scheduler.Context(), [shared, result]() mutable { std::move(*shared)(result); });
+				});
+			},
+			boost::asio::use_awaitable, std::move(task));
+	}
+
+	// runs on game thread - every probe is evaluated so that stats show which one dominates post-load latency
+	bool EvaluateProbes(const PluginClock::time_point closedAt, const std::uint32_t generation)
+	{
+		const std::vector<ReadinessProbe>& probes(_engine.ReadinessProbes());
+		const std::uint64_t elapsed(static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(PluginClock::now() - closedAt).count()));
+		bool allReady(true);
+		for (size_t index = 0; index < probes.size() && index < PauseTimeline::MaxProbes; ++index)
+		{
+			const bool ready(probes[index].ready());
+			PauseTimeline::Instance().RecordProbe(index, probes[index].name, ready);
+			if (ready && _probeReadyGeneration[index] != generation)
+			{
+				_probeReadyGeneration[index] = generation;
+				PauseTimeline::Instance().RecordProbeReady(index, elapsed);
+				DBG_MESSAGE("Readiness probe {} passed {} microseconds after Loading Menu closed", probes[index].name, elapsed);
+			}
+			allReady = allReady && ready;
+		}
+		return allReady;
+	}
+
+	// runs on game thread, from a frame task - resume queues its write to the game's freeze flag there too, so the two
+	// cannot interleave
+	bool Freeze(const std::uint32_t generation)
+	{
+		// input, error or a newer load screen may have ended this pause cycle while we waited
+		if (!_state.Transition(PauseState::Frozen, generation))
+		{
+			REL_DMESSAGE("Pause ended before freeze, state {}", PauseStateName(_state.State()));
+			return false;
+		}
+		_engine.SetFreezeTime(true);
+		PauseTimeline::Instance().Record(PausePhase::Frozen, generation);
+		return true;
+	}
+
+	// learned delay growth when the freeze lands before the player is ready
+	static constexpr double UnderrunGrowth = 1.5;
+	// readiness polling backoff
+	static constexpr std::chrono::milliseconds InitialProbeInterval{ 10 };
+	static constexpr std::chrono::milliseconds MaxProbeInterval{ 250 };
+	static constexpr std::chrono::milliseconds MaxReadinessWait{ 10000 };
+
+	GameEngine& _engine;
+	// scheduler thread only
+	DelayLearner _learner;
+	PauseLeases _leases;
+	// game thread only - pause cycle in which each probe last recorded its time to ready
+	std::array<std::uint32_t, PauseTimeline::MaxProbes> _probeReadyGeneration{};
+	// Armed indicates not first pass after launch - menu-closed must be preceded by menu-opened.
+	// Also acts as a guard for event sink management.
+	PauseStateMachine _state;
+	// scheduler thread only - generation of the running lifecycle, and of the last one cancelled
+	std::uint32_t _lifecycleGeneration = 0;
+	std::uint32_t _cancelledGeneration = 0;
+	bool _inputReceived = false;
+	// declared ahead of the timers, which are bound to its io_context
+	Scheduler _scheduler;
+	Scheduler::Timer _timer;
+	Scheduler::Timer _pauseDelayTimer;
+	Scheduler::Timer _inputTimer;
+};
+
+}
@@ -20,77 +20,81 @@ http://www.fsf.org/licensing/licenses
 *************************************************************************/
 
 // stripped down from Quick Loot RE ViewHandler.h
-// Pause logic per wsPauseQuestAliasScript.psc, courtesy of wskeever and bobbyclue
+#include <algorithm>
 #include <format>
-#include <boost/asio.hpp>
-#include <chrono>
 #include <thread>
 
+#include "Pausing/EffectClassifier.h"
 #include "Pausing/InputListener.h"
+#include "Pausing/GameEngine.h"
+#include "Pausing/PauseController.h"
+#include "Pausing/PauseVetoRules.h"
+#include "Pausing/SlowTimeIndex.h"
+#include "Data/FormIDSet.h"
 #include "Data/SettingsCache.h"
+#include "Utilities/utils.h"
 
 namespace palu
 {
 
+// Binds PauseController to the game - Loading Menu events in, freeze/input/dialogue/slow-time access out
 class PauseHandler :
-	public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+	public RE::BSTEventSink<RE::MenuOpenCloseEvent>,
+	public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent>,
+	public RE::BSTEventSink<RE::TESMagicEffectApplyEvent>,
+	public GameEngine
 {
 public:
-	PauseHandler(const PauseHandler&) = default;
+	PauseHandler(const PauseHandler&) = delete;
 
-	PauseHandler(PauseHandler&&) = default;
+	PauseHandler(PauseHandler&&) = delete;
 
-	PauseHandler() : _timer(_io_service), _thread()
+	PauseHandler() : _controller(*this, SettingsCache::Instance().GetDataFileName(LearnedDelayFileName))
 	{
-		_listener = std::make_unique<InputListener>(std::bind(&PauseHandler::Unpause, this));
-		Register();
+		_listener = std::make_unique<InputListener<UnpauseOnInput>>(UnpauseOnInput{ &_controller },
+			SettingsCache::Instance().PersistentInputSink());
+		AddReadinessProbes();
 		LoadData();
+		ResyncSlowTimeEffects();
+		Register();
 	}
 
 	~PauseHandler()
 	{
 		Unregister();
+		// no further timer or unpause jobs may touch this instance
+		_controller.Stop();
 		_listener.reset();
 	}
 
 	// set when game loading message is detected, to distinguish fast-travel and door transition from game load
 	void SetIsLoading()
 	{
-		_isLoading = true;
+		_controller.SetIsLoading();
+	}
+
+	// effects restored from a save, or reset for a new game, fire no apply/remove events - door and fast-travel load
+	// screens do, so need no resync
+	void OnGameLoaded()
+	{
+		ResyncSlowTimeEffects();
 	}
 
-	PauseHandler& operator=(const PauseHandler&) = default;
-	PauseHandler& operator=(PauseHandler&&) = default;
+	PauseHandler& operator=(const PauseHandler&) = delete;
+	PauseHandler& operator=(PauseHandler&&) = delete;
 
 	bool StartPause(const bool isSaving = false)
 	{
-		bool result(false);
-		// Skip pause if config demands it - cases are saving/loading/load-screen
-		if (!isSaving)
-		{
-			if (_isLoading)
-			{
-				DBG_MESSAGE("Called on game load");
-				_isLoading = false;
-				if (!SettingsCache::Instance().PauseOnLoad())
-				{
-					return false;
-				}
-			}
-			else
-			{
-				DBG_MESSAGE("Called on load-screen, not game load");
-				if (!SettingsCache::Instance().PauseOnLoadScreen())
-				{
-					return false;
-				}
-			}
-		}
-		else
-		{
-			DBG_MESSAGE("Called on game save");
-		}
+		return _controller.StartPause(isSaving);
+	}
 
+	void ProgressPause()
+	{
+		_controller.ProgressPause();
+	}
+
+	[[nodiscard]] bool CanFreeze() override
+	{
 		// Check MenuTopicManager is not active before we halt
 		if (!TryEnterCriticalSection(reinterpret_cast<LPCRITICAL_SECTION>(&RE::MenuTopicManager::GetSingleton()->criticalSection)))
 		{
@@ -117,85 +121,70 @@ public:
 			return false;
 		}
 		// If player is in Slow Time then do not pause
-		if (!IsSlowTimeEffectActive())
-		{
-			bool expected(false);
-			bool desired(true);
-			if (_paused.compare_exchange_strong(expected, desired))
-			{
-				REL_MESSAGE("OK to freeze time");
-				result = true;
-			}
-			else
-			{
-				REL_WARNING("Already paused, ignore new request");
-			}
-		}
+		const bool result(!IsSlowTimeEffectActive());
 		LeaveCriticalSection(reinterpret_cast<LPCRITICAL_SECTION>(&RE::MenuTopicManager::GetSingleton()->criticalSection));
 		return result;
 	}
 
-	void ProgressPause()
+	[[nodiscard]] bool ControlsReady() override
 	{
 		// check controls state
 		auto controls = RE::ControlMap::GetSingleton();
 		if (!controls)
 		{
 			REL_ERROR("ControlMap Singleton not valid");
-			Unpause();
-			return;
+			return false;
 		}
-		if (controls->IsPOVSwitchControlsEnabled() &&
-			controls->IsFightingControlsEnabled() &&
-			// mapped this over from the script, see https://github.com/SteveTownsend/PauseAfterLoadUnscripted/issues/12
-			// Game.IsJournalControlsEnabled() &&
-			controls->IsMainFourControlsEnabled() &&
-			controls->IsLookingControlsEnabled() &&
-			controls->IsMenuControlsEnabled() &&
-			controls->IsMovementControlsEnabled() &&
-			controls->IsSneakingControlsEnabled())
+		if (AllControlsEnabled(*controls))
 		{
-			// prepare Input Listener to block, if configured
-			const double ignoreInput(SettingsCache::Instance().CanUnpauseAfter());
-			_listener->SetDelay(ignoreInput);
-
-			// Activate InputHandler here - blocks input until any configured delay expires
-			_listener->Enable();
-
-			// Optionally, resume after configured delay
-			double delay(SettingsCache::Instance().ResumeAfter());
-			bool expected2(false);
-			bool desired2(true);
-			if (delay > 0.0 && _delayed.compare_exchange_strong(expected2, desired2))
-			{
-				REL_DMESSAGE("Resume game if no input for {:.1f} seconds, ignoring input for {:.1f} seconds", delay, ignoreInput);
-				_timer.expires_from_now(boost::posix_time::millisec(static_cast<int>((delay + ignoreInput) * 1000.0)));
-				_timer.async_wait([this](const boost::system::error_code& ec) {
-					if (!ec)
-					{
-						REL_DMESSAGE("Pause timed out");
-						Unpause();
-					}
-				});
-				// Start IO Service to handle timer
-				if (_thread.has_value())
-				{
-					_thread.reset();
-				}
-				_thread.emplace(std::bind(&PauseHandler::IOService, this));
-			}
+			return true;
 		}
-		else
+		REL_WARNING("Controls-Enabled State not all true: fighting {} looking {} journal {} menu {} movement {} sneaking {}",
+			controls->IsFightingControlsEnabled(),
+			controls->IsLookingControlsEnabled(),
+			controls->IsMainFourControlsEnabled(),
+			controls->IsMenuControlsEnabled(),
+			controls->IsMovementControlsEnabled(),
+			controls->IsSneakingControlsEnabled());
+		return false;
+	}
+
+	[[nodiscard]] const std::vector<ReadinessProbe>& ReadinessProbes() override
+	{
+		return _probes;
+	}
+
+	[[nodiscard]] std::uint32_t DestinationKey() override
+	{
+		auto player = RE::PlayerCharacter::GetSingleton();
+		auto cell = player ? player->GetParentCell() : nullptr;
+		if (!cell)
 		{
-			REL_WARNING("Controls-Enabled State not all true: fighting {} looking {} journal {} menu {} movement {} sneaking {}",
-				controls->IsFightingControlsEnabled(),
-				controls->IsLookingControlsEnabled(),
-				controls->IsMainFourControlsEnabled(),
-				controls->IsMenuControlsEnabled(),
-				controls->IsMovementControlsEnabled(),
-				controls->IsSneakingControlsEnabled());
-			Unpause();
+			return 0;
 		}
+		auto worldSpace = cell->IsInteriorCell() ? nullptr : player->GetWorldspace();
+		return worldSpace ? worldSpace->GetFormID() : cell->GetFormID();
+	}
+
+	void SetFreezeTime(const bool freeze) override
+	{
+		// pause game using CLSSE 'easy button'
+		RE::Main::GetSingleton()->freezeTime = freeze;
+	}
+
+	void QueueFrameTask(std::function<void()> task) override
+	{
+		SKSE::GetTaskInterface()->AddTask(std::move(task));
+	}
+
+	void EnableInput() override
+	{
+		_listener->Enable();
+	}
+
+	void DisableInput() override
+	{
+		_listener->Disable();
 	}
 
 protected:
@@ -232,39 +221,121 @@ protected:
 			a_event->menuName == intfcStr->loadingMenu) {
 			if (!a_event->opening)
 			{
-				// skip ProgressPause() if this is first pass after process launch, per log output above
-				if (_canPause)
-				{
-					// Loading Menu closed - need to pause
-					REL_MESSAGE("Loading Menu closed after preceding Opened event - pause OK");
-					ProgressPause();
-					_canPause = false;
-				}
-				else
-				{
-					REL_MESSAGE("Loading Menu closed without preceding Opened event - no pause");
-				}
+				_controller.OnLoadingMenuClosed();
 			}
 			// to confirm timings wrt Loading Menu handling
 			else
 			{
-				// set the stage for Pause when the corresponding menu-closed arrives
-				_canPause = StartPause();
-				REL_MESSAGE("Loading Menu opened - pause OK {}", _canPause);
+				_controller.OnLoadingMenuOpened();
 			}
 		}
 
 		return RE::BSEventNotifyControl::kContinue;
 	}
 
+	// a slow-time Magic Effect is being applied to the player - the event names the effect but not its active effect, so
+	// count it until the apply event that identifies it arrives
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESMagicEffectApplyEvent* a_event,
+		RE::BSTEventSource<RE::TESMagicEffectApplyEvent>*) override
+	{
+		auto player = RE::PlayerCharacter::GetSingleton();
+		if (!a_event || !player || a_event->target.get() != player || !_slowTimeEffects.contains(a_event->magicEffect)) {
+			return RE::BSEventNotifyControl::kContinue;
+		}
+		RecursiveLockGuard guard(_slowTimeLock);
+		_pendingSlowTimeEffects.fetch_add(1, std::memory_order_relaxed);
+		DBG_VMESSAGE("Slow-time Magic Effect {:08x} applied to player", a_event->magicEffect);
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	// keep the player's slow-time effects up to date as effects come and go
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+		RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) override
+	{
+		if (!a_event) {
+			return RE::BSEventNotifyControl::kContinue;
+		}
+		// an apply matters only while a slow-time Magic Effect is pending, a remove only while one is tracked - for every
+		// other effect on any actor this is the whole cost, with no lock
+		if (a_event->isApplied ? _pendingSlowTimeEffects.load(std::memory_order_relaxed) == 0 :
+			_trackedSlowTimeEffects.load(std::memory_order_relaxed) == 0) {
+			return RE::BSEventNotifyControl::kContinue;
+		}
+		auto player = RE::PlayerCharacter::GetSingleton();
+		if (!player || a_event->target.get() != player) {
+			return RE::BSEventNotifyControl::kContinue;
+		}
+		RecursiveLockGuard guard(_slowTimeLock);
+		const auto tracked(std::find(_slowTimeEffectIDs.cbegin(), _slowTimeEffectIDs.cend(), a_event->activeEffectUniqueID));
+		if (a_event->isApplied)
+		{
+			// only a pending slow-time Magic Effect is worth finding in the active effect list - every other apply stops here
+			if (tracked == _slowTimeEffectIDs.cend() && _pendingSlowTimeEffects.load(std::memory_order_relaxed) > 0 &&
+				IsSlowTimeEffect(a_event->activeEffectUniqueID))
+			{
+				DBG_VMESSAGE("Track slow-time effect {}", a_event->activeEffectUniqueID);
+				_slowTimeEffectIDs.push_back(a_event->activeEffectUniqueID);
+				_pendingSlowTimeEffects.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+		else if (tracked != _slowTimeEffectIDs.cend())
+		{
+			DBG_VMESSAGE("Untrack slow-time effect {}", a_event->activeEffectUniqueID);
+			_slowTimeEffectIDs.erase(tracked);
+		}
+		_trackedSlowTimeEffects.store(_slowTimeEffectIDs.size(), std::memory_order_relaxed);
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
 private:
 
+	static bool AllControlsEnabled(const RE::ControlMap& controls)
+	{
+		return controls.IsPOVSwitchControlsEnabled() &&
+			controls.IsFightingControlsEnabled() &&
+			// mapped this over from the script, see https://github.com/SteveTownsend/PauseAfterLoadUnscripted/issues/12
+			// Game.IsJournalControlsEnabled() &&
+			controls.IsMainFourControlsEnabled() &&
+			controls.IsLookingControlsEnabled() &&
+			controls.IsMenuControlsEnabled() &&
+			controls.IsMovementControlsEnabled() &&
+			controls.IsSneakingControlsEnabled();
+	}
+
+	// the controls-enabled checks from ProgressPause, plus signs that CELL setup is complete
+	void AddReadinessProbes()
+	{
+		_probes.push_back({ "ControlsEnabled", [] {
+			auto controls = RE::ControlMap::GetSingleton();
+			return controls && AllControlsEnabled(*controls);
+		} });
+		_probes.push_back({ "Player3DLoaded", [] {
+			auto player = RE::PlayerCharacter::GetSingleton();
+			return player && player->Is3DLoaded();
+		} });
+		_probes.push_back({ "ParentCellAttached", [] {
+			auto player = RE::PlayerCharacter::GetSingleton();
+			auto cell = player ? player->GetParentCell() : nullptr;
+			return cell && cell->IsAttached();
+		} });
+		_probes.push_back({ "NoLoadingMenu", [] {
+			auto ui = RE::UI::GetSingleton();
+			auto intfcStr = RE::InterfaceStrings::GetSingleton();
+			return ui && intfcStr && !ui->IsMenuOpen(intfcStr->loadingMenu);
+		} });
+	}
+
 	void Register()
 	{
 		auto menuSrc = RE::UI::GetSingleton();
 		if (menuSrc) {
 			menuSrc->AddEventSink(this);
 		}
+		auto scriptSrc = RE::ScriptEventSourceHolder::GetSingleton();
+		if (scriptSrc) {
+			scriptSrc->AddEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+			scriptSrc->AddEventSink<RE::TESMagicEffectApplyEvent>(this);
+		}
 	}
 
 	void Unregister()
@@ -273,41 +344,109 @@ private:
 		if (menuSrc) {
 			menuSrc->RemoveEventSink(this);
 		}
+		auto scriptSrc = RE::ScriptEventSourceHolder::GetSingleton();
+		if (scriptSrc) {
+			scriptSrc->RemoveEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+			scriptSrc->RemoveEventSink<RE::TESMagicEffectApplyEvent>(this);
+		}
 	}
 
 	bool LoadData()
 	{
-#ifdef _PROFILING
 		WindowsUtils::ScopedTimer elapsed("Startup: Load Game Data");
-#endif
 		RE::TESDataHandler* dhnd = RE::TESDataHandler::GetSingleton();
 		if (!dhnd)
 			return false;
 
-		// Save MGEF with Slow Time archetype and with Value Modifier on Bow Speed Bonus.
-		// Constant Effects skipped to avoid inoperable state.
-		for (RE::EffectSetting* effect : dhnd->GetFormArray<RE::EffectSetting>())
+		// unchanged load order and veto rules - reuse the FormIDs classified on an earlier launch
+		const SettingsCache& settings(SettingsCache::Instance());
+		const std::string configuration(settings.PauseVetoRules() + '\n' + settings.PauseVetoFormIDs());
+		std::uint64_t fingerprint(0);
 		{
-			if (effect->HasArchetype(RE::EffectSetting::Archetype::kSlowTime) &&
-				effect->data.castingType != RE::MagicSystem::CastingType::kConstantEffect)
-			{
-				REL_VMESSAGE("SlowTime Magic Effect : {}({:08x})", effect->GetName(), effect->GetFormID());
-				_slowTimeEffects.insert(effect);
-			}
-			else if (effect->HasArchetype(RE::EffectSetting::Archetype::kValueModifier) &&
-				effect->data.primaryAV == RE::ActorValue::kBowSpeedBonus &&
-				effect->data.castingType != RE::MagicSystem::CastingType::kConstantEffect)
-			{
-				REL_VMESSAGE("ValueModifier-BowSpeedBonus Magic Effect : {}({:08x})", effect->GetName(), effect->GetFormID());
-				_slowTimeEffects.insert(effect);
-			}
+			WindowsUtils::ScopedTimer fingerprintElapsed("Startup: Fingerprint Load Order");
+			fingerprint = SlowTimeIndex::Fingerprint(*dhnd, configuration);
+		}
+		if (const auto indexed = _slowTimeIndex.Load(fingerprint))
+		{
+			_slowTimeEffects = FormIDSet::View(*indexed);
+			REL_MESSAGE("Plugin Data load complete! {} Magic Effects prevent pause, from index", _slowTimeEffects.size());
+			return true;
 		}
 
-		REL_MESSAGE("Plugin Data load complete!");
+		const PauseVetoRules rules(PauseVetoRules::Compile(settings.PauseVetoRules(), settings.PauseVetoFormIDs(), *dhnd));
+		// classify in chunks across a few workers - merged and sorted by FormIDSet
+		auto& forms(dhnd->GetFormArray<RE::EffectSetting>());
+		const size_t count(forms.size());
+		const size_t workers(EffectClassifier::Workers(count));
+		{
+			WindowsUtils::ScopedTimer classifyElapsed("Startup: Classify Magic Effects");
+			_slowTimeEffects = FormIDSet(EffectClassifier::Classify(std::span<RE::EffectSetting* const>(forms.data(), count), rules, workers));
+		}
+		_slowTimeIndex.Save(fingerprint, _slowTimeEffects);
+
+		REL_MESSAGE("Plugin Data load complete! {} of {} Magic Effects prevent pause, {} workers", _slowTimeEffects.size(), count, workers);
 		return true;
 	}
 
+	[[nodiscard]] bool IsSlowTime(const RE::EffectSetting* setting) const
+	{
+		return setting && _slowTimeEffects.contains(setting->GetFormID());
+	}
+
+	// true if the player's active effect with the given unique ID is one of the slow-time effects
+	[[nodiscard]] bool IsSlowTimeEffect(const std::uint16_t uniqueID) const
+	{
+		auto target = RE::PlayerCharacter::GetSingleton()->AsMagicTarget();
+		auto effects = target ? target->GetActiveEffectList() : nullptr;
+		if (!effects) {
+			return false;
+		}
+		for (auto& effect : *effects) {
+			if (effect && effect->usUniqueID == uniqueID) {
+				return IsSlowTime(effect->GetBaseObject());
+			}
+		}
+		return false;
+	}
+
+	// rebuild the tracked slow-time effects from the player's active effect list
+	void ResyncSlowTimeEffects()
+	{
+		auto player = RE::PlayerCharacter::GetSingleton();
+		auto target = player ? player->AsMagicTarget() : nullptr;
+		auto effects = target ? target->GetActiveEffectList() : nullptr;
+		RecursiveLockGuard guard(_slowTimeLock);
+		_slowTimeEffectIDs.clear();
+		_pendingSlowTimeEffects.store(0, std::memory_order_relaxed);
+		if (effects) {
+			for (auto& effect : *effects) {
+				if (effect && IsSlowTime(effect->GetBaseObject())) {
+					_slowTimeEffectIDs.push_back(effect->usUniqueID);
+				}
+			}
+		}
+		_trackedSlowTimeEffects.store(_slowTimeEffectIDs.size(), std::memory_order_relaxed);
+		DBG_MESSAGE("Resync found {} slow-time effects", _slowTimeEffectIDs.size());
+	}
+
 	[[nodiscard]] bool IsSlowTimeEffectActive() const
+	{
+		// no slow-time effect on the player, or applied and not yet tracked - the usual case, and the end of the check
+		if (_trackedSlowTimeEffects.load(std::memory_order_relaxed) == 0 && _pendingSlowTimeEffects.load(std::memory_order_relaxed) == 0)
+		{
+#ifdef _DEBUG
+			if (ScanForSlowTimeEffect())
+			{
+				REL_WARNING("Slow-time effect tracking missed an active effect");
+			}
+#endif
+			return false;
+		}
+		// tracked effects may be inactive, which does not prevent Pause
+		return ScanForSlowTimeEffect();
+	}
+
+	[[nodiscard]] bool ScanForSlowTimeEffect() const
 	{
 		// Use active effects directly - CLSSE has no appropriate function
 		auto target = RE::PlayerCharacter::GetSingleton()->AsMagicTarget();
@@ -321,16 +460,16 @@ private:
 			setting = effect ? effect->GetBaseObject() : nullptr;
 			if (!setting)
 				continue;
-			if (_slowTimeEffects.contains(setting))
+			if (_slowTimeEffects.contains(setting->GetFormID()))
 			{
 				// Inactive effects should not prevent Pause
 				if (effect->flags.any(RE::ActiveEffect::Flag::kInactive))
 				{
-					REL_DMESSAGE("Skip Inactive SlowTime or ValueModifier-BowSpeedBonus archetype effect : {}({:08x})",
+					REL_DMESSAGE("Skip Inactive pause veto effect : {}({:08x})",
 						setting->GetName(), setting->GetFormID());
 					continue;
 				}
-				REL_WARNING("Player subject to Active non-constant-cast SlowTime or ValueModifier-BowSpeedBonus archetype effect : {}({:08x})",
+				REL_WARNING("Player subject to Active pause veto effect : {}({:08x})",
 					setting->GetName(), setting->GetFormID());
 				return true;
 			}
@@ -338,61 +477,30 @@ private:
 		return false;
 	}
 
-	void Unpause()
-	{
-		// cancel delay timer if active
-		bool expected(true);
-		bool desired(false);
-		if (_delayed.compare_exchange_strong(expected, desired))
-		{
-			REL_DMESSAGE("Cancel active pause timer");
-			_timer.cancel();
-		}
-
-		bool expected2(true);
-		bool desired2(false);
-		if (_paused.compare_exchange_strong(expected2, desired2))
-		{
-			REL_DMESSAGE("Restart game");
-			_listener->Disable();
-			// Resume game
-			RE::Main::GetSingleton()->freezeTime = false;
-		}
-		else
-		{
-			REL_WARNING("Already unpaused, ignore new request");
-		}
-	}
-
-	void IOService()
+	// input listener callback - a plain pointer, so the input thread never copies or allocates to deliver it
+	struct UnpauseOnInput
 	{
-		REL_DMESSAGE("Starting timer thread");
-		// delay pause for CELL setup, if configured
-		double pauseDelay(SettingsCache::Instance().PauseDelay());
-		if (pauseDelay > 0.0)
-		{
-			REL_MESSAGE("Delay for {:.1f} seconds", pauseDelay);
-			std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(pauseDelay * 1000.0));
-		}
-		// pause game using CLSSE 'easy button'
-		RE::Main::GetSingleton()->freezeTime = true;
-
-		_io_service.run_one();
-		_io_service.restart();
-		REL_DMESSAGE("Exiting timer thread");
-	}
-
-	std::unique_ptr<InputListener> _listener;
-	// indicates not first pass after launch - menu-closed must be preceded by menu-opened
-	bool _canPause{ false };
-	bool _isLoading{ false };
-	// acts as a guard for event sink management
-	std::atomic<bool> _paused{ false };
-	std::atomic<bool> _delayed{ false };
-	std::unordered_set<RE::EffectSetting*> _slowTimeEffects;
-	boost::asio::io_service _io_service;
-	boost::asio::deadline_timer _timer;
-	std::optional<std::jthread> _thread;
+		PauseController* controller;
+		void operator()() const { controller->Unpause(); }
+	};
+
+	inline static const wchar_t* LearnedDelayFileName = L"PauseAfterLoadUnscripted.delays";
+	inline static const wchar_t* SlowTimeIndexFileName = L"PauseAfterLoadUnscripted.slowtime";
+
+	// declared first so that it outlives the set, which may view its mapped file
+	SlowTimeIndex _slowTimeIndex{ SettingsCache::Instance().GetDataFileName(SlowTimeIndexFileName) };
+	FormIDSet _slowTimeEffects;
+	// unique IDs of slow-time effects applied to the player and not yet removed, maintained on the game thread
+	RecursiveLock _slowTimeLock;
+	std::vector<std::uint16_t> _slowTimeEffectIDs;
+	std::atomic<size_t> _trackedSlowTimeEffects{ 0 };
+	// slow-time Magic Effects applied to the player whose active effect is not yet tracked. One resisted, or applied in an
+	// unexpected event order, leaves this set until the next game load resyncs - the pause check then scans, so stays
+	// correct.
+	std::atomic<size_t> _pendingSlowTimeEffects{ 0 };
+	std::vector<ReadinessProbe> _probes;
+	std::unique_ptr<InputListener<UnpauseOnInput>> _listener;
+	PauseController _controller;
 };
 
 }
@@ -0,0 +1,129 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+enum class PauseReason : std::uint8_t
+{
+	Save = 0,
+	GameLoad,
+	LoadScreen,
+	MaxReason
+};
+
+constexpr const char* PauseReasonName(const PauseReason reason)
+{
+	constexpr std::array<const char*, static_cast<size_t>(PauseReason::MaxReason)> names = {
+		"Save", "GameLoad", "LoadScreen"
+	};
+	return reason < PauseReason::MaxReason ? names[static_cast<size_t>(reason)] : "Invalid";
+}
+
+// Overlapping pause triggers each hold a lease, one slot per reason. The game stays frozen while any lease is live.
+// A lease is pending, with no expiry, from StartPause until its pause progresses, then expires ResumeAfter later
+// or never if ResumeAfter is 0. Only touched from the scheduler thread.
+class PauseLeases
+{
+public:
+	using Clock = PluginClock;
+
+	void Acquire(const PauseReason reason)
+	{
+		Lease& lease(_leases[static_cast<size_t>(reason)]);
+		lease.live = true;
+		lease.pending = true;
+		lease.expiry = Clock::time_point::max();
+	}
+
+	// start the clock on every pending lease - a missing expiry means held until input
+	void Activate(const std::optional<Clock::time_point> expiry)
+	{
+		for (Lease& lease : _leases)
+		{
+			if (lease.live && lease.pending)
+			{
+				lease.pending = false;
+				lease.expiry = expiry.value_or(Clock::time_point::max());
+			}
+		}
+	}
+
+	void ReleaseAll()
+	{
+		_leases = {};
+	}
+
+	// drop expired leases, true if any remain live
+	bool ReleaseExpired(const Clock::time_point now)
+	{
+		bool anyLive(false);
+		for (size_t reason = 0; reason < _leases.size(); ++reason)
+		{
+			Lease& lease(_leases[reason]);
+			if (lease.live && !lease.pending && lease.expiry <= now)
+			{
+				REL_DMESSAGE("Pause lease {} expired", PauseReasonName(static_cast<PauseReason>(reason)));
+				lease = {};
+			}
+			anyLive = anyLive || lease.live;
+		}
+		return anyLive;
+	}
+
+	// when the resume timer should fire - none while any lease is pending or held until input
+	[[nodiscard]] std::optional<Clock::time_point> LatestExpiry() const
+	{
+		std::optional<Clock::time_point> latest;
+		for (const Lease& lease : _leases)
+		{
+			if (!lease.live)
+			{
+				continue;
+			}
+			if (lease.pending || lease.expiry == Clock::time_point::max())
+			{
+				return std::nullopt;
+			}
+			latest = latest.has_value() ? std::max(*latest, lease.expiry) : lease.expiry;
+		}
+		return latest;
+	}
+
+private:
+	struct Lease
+	{
+		bool live{ false };
+		bool pending{ false };
+		Clock::time_point expiry{ Clock::time_point::max() };
+	};
+
+	std::array<Lease, static_cast<size_t>(PauseReason::MaxReason)> _leases{};
+};
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace palu
+{
+
+// Pause lifecycle. Every transition is a single CAS on one packed word, so the UI sink, SKSE message thread,
+// input thread and scheduler thread never see a torn combination of flags.
+enum class PauseState : std::uint8_t
+{
+	Idle = 0,	// no pause requested
+	Armed,		// StartPause accepted, waiting for Loading Menu close
+	Delaying,	// freeze scheduled, PauseDelay pending
+	Frozen,		// game time frozen, waiting for input or timeout
+	Resuming,	// unfreeze in progress
+	MaxState
+};
+
+constexpr const char* PauseStateName(const PauseState state)
+{
+	constexpr std::array<const char*, static_cast<size_t>(PauseState::MaxState)> names = {
+		"Idle", "Armed", "Delaying", "Frozen", "Resuming"
+	};
+	return state < PauseState::MaxState ? names[static_cast<size_t>(state)] : "Invalid";
+}
+
+class PauseStateMachine
+{
+public:
+	struct Transitioned
+	{
+		PauseState from;
+		// identifies the pause cycle - timers armed for an earlier cycle must not act on this one
+		std::uint32_t generation;
+	};
+
+	PauseStateMachine() = default;
+
+	[[nodiscard]] PauseState State() const { return StateOf(_word.load(std::memory_order_acquire)); }
+	[[nodiscard]] std::uint32_t Generation() const { return GenerationOf(_word.load(std::memory_order_acquire)); }
+	[[nodiscard]] std::uint64_t IllegalTransitions() const { return _illegalTransitions.load(std::memory_order_relaxed); }
+
+	// Move to the requested state if the table allows it from the current state and, when supplied, the pause cycle
+	// still matches. Entering Armed starts a new cycle. Illegal requests are rejected and counted.
+	std::optional<Transitioned> Transition(const PauseState to, const std::optional<std::uint32_t> generation = std::nullopt)
+	{
+		std::uint64_t current(_word.load(std::memory_order_acquire));
+		while (true)
+		{
+			const PauseState from(StateOf(current));
+			if (!IsAllowed(from, to) || (generation.has_value() && *generation != GenerationOf(current)))
+			{
+				_illegalTransitions.fetch_add(1, std::memory_order_relaxed);
+				return std::nullopt;
+			}
+			std::uint32_t nextGeneration(GenerationOf(current));
+			if (to == PauseState::Armed)
+			{
+				++nextGeneration;
+			}
+			const std::uint64_t desired(Pack(to, (current & LoadingFlag) != 0, nextGeneration));
+			if (_word.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return Transitioned{ from, nextGeneration };
+			}
+		}
+	}
+
+	// game-load flag shares the word so it is consumed atomically with respect to state changes
+	void SetLoading() { _word.fetch_or(LoadingFlag, std::memory_order_acq_rel); }
+	bool ConsumeLoading() { return (_word.fetch_and(~LoadingFlag, std::memory_order_acq_rel) & LoadingFlag) != 0; }
+
+	static constexpr bool IsAllowed(const PauseState from, const PauseState to)
+	{
+		return from < PauseState::MaxState && to < PauseState::MaxState &&
+			TransitionTable[static_cast<size_t>(from)][static_cast<size_t>(to)];
+	}
+
+private:
+	static constexpr size_t StateCount = static_cast<size_t>(PauseState::MaxState);
+	// rows are from-state, columns to-state, order per PauseState
+	static constexpr std::array<std::array<bool, StateCount>, StateCount> TransitionTable = { {
+		//  Idle   Armed  Delaying Frozen Resuming
+		{ false, true,  false,   false, false },	// Idle
+		{ false, false, true,    false, true  },	// Armed
+		{ false, true,  false,   true,  true  },	// Delaying - new load screen takes over the pending pause
+		{ false, false, false,   false, true  },	// Frozen
+		{ true,  false, false,   false, false },	// Resuming
+	} };
+
+	// low byte state, bit 8 game-load flag, high 32 bits pause cycle generation
+	static constexpr std::uint64_t StateMask = 0xff;
+	static constexpr std::uint64_t LoadingFlag = 0x100;
+	static constexpr unsigned GenerationShift = 32;
+
+	static constexpr PauseState StateOf(const std::uint64_t word) { return static_cast<PauseState>(word & StateMask); }
+	static constexpr std::uint32_t GenerationOf(const std::uint64_t word) { return static_cast<std::uint32_t>(word >> GenerationShift); }
+	static constexpr std::uint64_t Pack(const PauseState state, const bool loading, const std::uint32_t generation)
+	{
+		return static_cast<std::uint64_t>(state) | (loading ? LoadingFlag : 0) |
+			(static_cast<std::uint64_t>(generation) << GenerationShift);
+	}
+
+	std::atomic<std::uint64_t> _word{ Pack(PauseState::Idle, false, 0) };
+	std::atomic<std::uint64_t> _illegalTransitions{ 0 };
+
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+};
+
+static_assert(PauseStateMachine::IsAllowed(PauseState::Idle, PauseState::Armed));
+static_assert(!PauseStateMachine::IsAllowed(PauseState::Frozen, PauseState::Armed));
+static_assert(PauseStateMachine::IsAllowed(PauseState::Resuming, PauseState::Idle));
+
+}
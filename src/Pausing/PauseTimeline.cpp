@@ -0,0 +1,232 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/PauseTimeline.h"
+
+#include <bit>
+#include <fstream>
+
+namespace palu
+{
+
+size_t LatencyHistogram::BucketFor(const std::uint64_t micros)
+{
+	if (micros < SubBuckets)
+	{
+		return static_cast<size_t>(micros);
+	}
+	const unsigned msb(static_cast<unsigned>(std::bit_width(micros)) - 1);
+	const unsigned magnitude(msb - SubBucketBits + 1);
+	if (magnitude > Magnitudes)
+	{
+		return BucketCount - 1;
+	}
+	const size_t subBucket((micros >> (msb - SubBucketBits)) & (SubBuckets - 1));
+	return magnitude * SubBuckets + subBucket;
+}
+
+std::uint64_t LatencyHistogram::UpperBound(const size_t bucket)
+{
+	const size_t magnitude(bucket / SubBuckets);
+	const size_t subBucket(bucket % SubBuckets);
+	if (magnitude == 0)
+	{
+		return subBucket;
+	}
+	const size_t shift(magnitude - 1);
+	return ((SubBuckets + subBucket) << shift) + (1ULL << shift) - 1;
+}
+
+void LatencyHistogram::Record(const std::uint64_t micros)
+{
+	_buckets[BucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	std::uint64_t currentMax(_max.load(std::memory_order_relaxed));
+	while (micros > currentMax && !_max.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed))
+	{
+	}
+}
+
+std::uint64_t LatencyHistogram::Percentile(const double fraction) const
+{
+	const std::uint64_t count(Count());
+	if (count == 0)
+	{
+		return 0;
+	}
+	const std::uint64_t target(std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * static_cast<double>(count) + 0.5)));
+	std::uint64_t seen(0);
+	for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+	{
+		seen += _buckets[bucket].load(std::memory_order_relaxed);
+		if (seen >= target)
+		{
+			return std::min(UpperBound(bucket), Max());
+		}
+	}
+	return Max();
+}
+
+PauseTimeline& PauseTimeline::Instance()
+{
+	static PauseTimeline instance;
+	return instance;
+}
+
+void PauseTimeline::Record(const PausePhase phase, const std::uint32_t generation)
+{
+	const std::int64_t now(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count());
+	// one sample per phase per pause cycle - repeated input or overlapping load screens only add ring entries
+	const std::uint64_t mark(Mark(generation, now));
+	std::atomic<std::uint64_t>& phaseMark(_marks[static_cast<size_t>(phase)]);
+	std::uint64_t earlier(phaseMark.load(std::memory_order_acquire));
+	bool first(false);
+	while (!SameGeneration(earlier, mark))
+	{
+		if (phaseMark.compare_exchange_weak(earlier, mark, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			first = true;
+			break;
+		}
+	}
+	const PausePhase preceding(PrecedingPhase[static_cast<size_t>(phase)]);
+	if (first && preceding != PausePhase::MaxPhase)
+	{
+		const std::uint64_t before(_marks[static_cast<size_t>(preceding)].load(std::memory_order_acquire));
+		if (SameGeneration(before, mark) && (mark & MarkMicrosMask) >= (before & MarkMicrosMask))
+		{
+			_histograms[static_cast<size_t>(phase)].Record((mark & MarkMicrosMask) - (before & MarkMicrosMask));
+		}
+	}
+
+	// seqlock per slot - readers discard a slot whose sequence changes while they copy it
+	const std::uint64_t index(_next.fetch_add(1, std::memory_order_relaxed));
+	Entry& entry(_entries[index & (Capacity - 1)]);
+	entry.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	entry.micros.store(now, std::memory_order_relaxed);
+	entry.generation.store(generation, std::memory_order_relaxed);
+	entry.threadId.store(static_cast<std::uint32_t>(spdlog::details::os::thread_id()), std::memory_order_relaxed);
+	entry.phase.store(phase, std::memory_order_relaxed);
+	entry.sequence.store(index + 1, std::memory_order_release);
+}
+
+void PauseTimeline::RecordProbe(const size_t probe, const char* name, const bool passed)
+{
+	if (probe >= MaxProbes)
+	{
+		return;
+	}
+	ProbeStats& stats(_probes[probe]);
+	stats.name.store(name, std::memory_order_relaxed);
+	(passed ? stats.passed : stats.failed).fetch_add(1, std::memory_order_relaxed);
+}
+
+void PauseTimeline::RecordProbeReady(const size_t probe, const std::uint64_t micros)
+{
+	if (probe < MaxProbes)
+	{
+		_probes[probe].timeToReady.Record(micros);
+	}
+}
+
+void PauseTimeline::Dump()
+{
+	if (_dumpFile.empty())
+	{
+		return;
+	}
+	std::ofstream output(_dumpFile, std::ios::out | std::ios::app);
+	if (!output)
+	{
+		REL_WARNING("Cannot open pause timeline file {}", _dumpFile);
+		return;
+	}
+	const std::uint64_t next(_next.load(std::memory_order_acquire));
+	const std::uint64_t first(next > Capacity ? std::max(_dumped, next - Capacity) : _dumped);
+	if (first > _dumped)
+	{
+		output << "-- " << first - _dumped << " events overwritten before dump\n";
+	}
+	for (std::uint64_t index = first; index < next; ++index)
+	{
+		const Entry& entry(_entries[index & (Capacity - 1)]);
+		if (entry.sequence.load(std::memory_order_acquire) != index + 1)
+		{
+			continue;
+		}
+		const std::int64_t micros(entry.micros.load(std::memory_order_relaxed));
+		const std::uint32_t generation(entry.generation.load(std::memory_order_relaxed));
+		const std::uint32_t threadId(entry.threadId.load(std::memory_order_relaxed));
+		const PausePhase phase(entry.phase.load(std::memory_order_relaxed));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (entry.sequence.load(std::memory_order_relaxed) != index + 1)
+		{
+			continue;
+		}
+		output << micros << " us cycle " << generation << " thread " << threadId << ' ' << PausePhaseName(phase) << '\n';
+	}
+	_dumped = next;
+
+	output << "-- latency since preceding phase in the same cycle, microseconds: count p50 p90 p99 max\n";
+	for (size_t phase = 0; phase < _histograms.size(); ++phase)
+	{
+		const LatencyHistogram& histogram(_histograms[phase]);
+		if (histogram.Count() == 0)
+		{
+			continue;
+		}
+		output << PausePhaseName(static_cast<PausePhase>(phase)) << " since " << PausePhaseName(PrecedingPhase[phase]) << ' ' <<
+			histogram.Count() << ' ' << histogram.Percentile(0.5) << ' ' << histogram.Percentile(0.9) << ' ' <<
+			histogram.Percentile(0.99) << ' ' << histogram.Max() << '\n';
+	}
+
+	output << "-- readiness probes: passed failed, then time to ready in microseconds: count p50 p90 p99 max\n";
+	for (const ProbeStats& probe : _probes)
+	{
+		const char* name(probe.name.load(std::memory_order_relaxed));
+		if (!name)
+		{
+			continue;
+		}
+		output << name << ' ' << probe.passed.load(std::memory_order_relaxed) << ' ' << probe.failed.load(std::memory_order_relaxed) <<
+			' ' << probe.timeToReady.Count() << ' ' << probe.timeToReady.Percentile(0.5) << ' ' <<
+			probe.timeToReady.Percentile(0.9) << ' ' << probe.timeToReady.Percentile(0.99) << ' ' << probe.timeToReady.Max() << '\n';
+	}
+
+	if (_inputBatch.Count() > 0)
+	{
+		output << "-- input events examined per batch: count p50 p90 p99 max\n" << _inputBatch.Count() << ' ' <<
+			_inputBatch.Percentile(0.5) << ' ' << _inputBatch.Percentile(0.9) << ' ' << _inputBatch.Percentile(0.99) << ' ' <<
+			_inputBatch.Max() << '\n';
+	}
+	const std::uint64_t dispatchEvents(_inputDispatchEvents.load(std::memory_order_relaxed));
+	if (dispatchEvents > 0)
+	{
+		output << "-- input dispatch per batch, nanoseconds: count p50 p90 p99 max, then nanoseconds per event\n" <<
+			_inputDispatch.Count() << ' ' << _inputDispatch.Percentile(0.5) << ' ' << _inputDispatch.Percentile(0.9) << ' ' <<
+			_inputDispatch.Percentile(0.99) << ' ' << _inputDispatch.Max() << ' ' <<
+			_inputDispatchNanos.load(std::memory_order_relaxed) / dispatchEvents << '\n';
+	}
+	output << "-- input sink registration changes " << _inputSinkChanges.load(std::memory_order_relaxed) << '\n';
+}
+
+}
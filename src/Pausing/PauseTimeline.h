@@ -0,0 +1,170 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+enum class PausePhase : std::uint8_t
+{
+	LoadingMenuOpened = 0,
+	LoadingMenuClosed,
+	PauseProgressed,
+	Frozen,
+	InputReceived,
+	TimedOut,
+	Resumed,
+	MaxPhase
+};
+
+constexpr const char* PausePhaseName(const PausePhase phase)
+{
+	constexpr std::array<const char*, static_cast<size_t>(PausePhase::MaxPhase)> names = {
+		"LoadingMenuOpened", "LoadingMenuClosed", "PauseProgressed", "Frozen", "InputReceived", "TimedOut", "Resumed"
+	};
+	return phase < PausePhase::MaxPhase ? names[static_cast<size_t>(phase)] : "Invalid";
+}
+
+// Log-linear latency histogram in microseconds, HDR-style: each power of two is split into SubBuckets linear
+// buckets, so relative error is bounded at 1/SubBuckets across the whole range. Updates are relaxed atomics.
+class LatencyHistogram
+{
+public:
+	void Record(const std::uint64_t micros);
+	[[nodiscard]] std::uint64_t Count() const { return _count.load(std::memory_order_relaxed); }
+	[[nodiscard]] std::uint64_t Max() const { return _max.load(std::memory_order_relaxed); }
+	// value at or below which the given fraction of samples fall, approximated to bucket upper bound
+	[[nodiscard]] std::uint64_t Percentile(const double fraction) const;
+
+private:
+	static constexpr unsigned SubBucketBits = 3;
+	static constexpr unsigned SubBuckets = 1 << SubBucketBits;
+	// 2^40 microseconds is about 12 days, ample for any pause
+	static constexpr unsigned Magnitudes = 40;
+	static constexpr size_t BucketCount = (Magnitudes + 1) * SubBuckets;
+
+	static size_t BucketFor(const std::uint64_t micros);
+	static std::uint64_t UpperBound(const size_t bucket);
+
+	std::array<std::atomic<std::uint64_t>, BucketCount> _buckets{};
+	std::atomic<std::uint64_t> _count{ 0 };
+	std::atomic<std::uint64_t> _max{ 0 };
+};
+
+// Fixed-size lock-free record of pause phase events from every thread involved, plus per-phase histograms of the
+// time since the phase that precedes it in the same pause cycle. Writers never block; the oldest entries are overwritten.
+class PauseTimeline
+{
+public:
+	// constructed on first use - thread-safe, phases are recorded from the game, input and scheduler threads
+	static PauseTimeline& Instance();
+	PauseTimeline() = default;
+
+	void Record(const PausePhase phase, const std::uint32_t generation);
+
+	// readiness probe outcome per poll, and time from Loading Menu close to first pass in a pause cycle
+	static constexpr size_t MaxProbes = 8;
+	void RecordProbe(const size_t probe, const char* name, const bool passed);
+	void RecordProbeReady(const size_t probe, const std::uint64_t micros);
+	// input events examined per InputEvent chain delivered while the listener is accepting input
+	void RecordInputBatch(const std::uint64_t examined) { _inputBatch.Record(examined); }
+	// input thread time spent on one InputEvent chain, and the events it examined
+	void RecordInputDispatch(const std::uint64_t nanos, const std::uint64_t events)
+	{
+		_inputDispatch.Record(nanos);
+		_inputDispatchNanos.fetch_add(nanos, std::memory_order_relaxed);
+		_inputDispatchEvents.fetch_add(events, std::memory_order_relaxed);
+	}
+	// AddEventSink or RemoveEventSink call on the input event source
+	void RecordInputSinkChange() { _inputSinkChanges.fetch_add(1, std::memory_order_relaxed); }
+
+	// target for Dump, set once at startup
+	void SetDumpFile(const std::string& fileName) { _dumpFile = fileName; }
+	// append events recorded since the last dump and a histogram summary to the dump file
+	void Dump();
+
+private:
+	using Clock = PluginClock;
+
+	struct Entry
+	{
+		// ring index + 1 of the write that completed this slot, 0 while empty or being rewritten
+		std::atomic<std::uint64_t> sequence{ 0 };
+		std::atomic<std::int64_t> micros{ 0 };
+		std::atomic<std::uint32_t> generation{ 0 };
+		std::atomic<std::uint32_t> threadId{ 0 };
+		std::atomic<PausePhase> phase{ PausePhase::MaxPhase };
+	};
+
+	static constexpr size_t Capacity = 1024;
+	static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+	// phase each histogram measures from, MaxPhase for none
+	static constexpr std::array<PausePhase, static_cast<size_t>(PausePhase::MaxPhase)> PrecedingPhase = {
+		PausePhase::MaxPhase, PausePhase::LoadingMenuOpened, PausePhase::LoadingMenuClosed, PausePhase::PauseProgressed,
+		PausePhase::Frozen, PausePhase::Frozen, PausePhase::Frozen
+	};
+
+	// first time each phase was seen in a pause cycle - low bits of the cycle in the top 16 bits, microseconds below,
+	// one word so that other threads read the pair consistently
+	static constexpr unsigned MarkGenerationShift = 48;
+	static constexpr std::uint64_t MarkMicrosMask = (1ULL << MarkGenerationShift) - 1;
+	static constexpr std::uint64_t Mark(const std::uint32_t generation, const std::int64_t micros)
+	{
+		return (static_cast<std::uint64_t>(generation & 0xFFFF) << MarkGenerationShift) |
+			(static_cast<std::uint64_t>(micros) & MarkMicrosMask);
+	}
+	static constexpr bool SameGeneration(const std::uint64_t mark, const std::uint64_t other)
+	{
+		return mark != 0 && other != 0 && (mark >> MarkGenerationShift) == (other >> MarkGenerationShift);
+	}
+
+	std::array<Entry, Capacity> _entries;
+	std::atomic<std::uint64_t> _next{ 0 };
+	std::array<std::atomic<std::uint64_t>, static_cast<size_t>(PausePhase::MaxPhase)> _marks{};
+	std::array<LatencyHistogram, static_cast<size_t>(PausePhase::MaxPhase)> _histograms;
+
+	struct ProbeStats
+	{
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<std::uint64_t> passed{ 0 };
+		std::atomic<std::uint64_t> failed{ 0 };
+		LatencyHistogram timeToReady;
+	};
+	std::array<ProbeStats, MaxProbes> _probes;
+	LatencyHistogram _inputBatch;
+	LatencyHistogram _inputDispatch;
+	std::atomic<std::uint64_t> _inputDispatchNanos{ 0 };
+	std::atomic<std::uint64_t> _inputDispatchEvents{ 0 };
+	std::atomic<std::uint64_t> _inputSinkChanges{ 0 };
+	// only touched by Dump, which runs on the scheduler thread
+	std::uint64_t _dumped{ 0 };
+	std::string _dumpFile;
+};
+
+}
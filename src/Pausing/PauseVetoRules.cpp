@@ -0,0 +1,277 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/PauseVetoRules.h"
+#include "Data/SettingsCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <cstdlib>
+#include <string_view>
+
+namespace palu
+{
+
+namespace
+{
+	std::vector<std::string> Split(const std::string& text, const char separator)
+	{
+		std::vector<std::string> parts;
+		size_t start(0);
+		while (start <= text.length())
+		{
+			size_t end(text.find(separator, start));
+			if (end == std::string::npos)
+			{
+				end = text.length();
+			}
+			std::string part(text.substr(start, end - start));
+			const size_t first(part.find_first_not_of(" \t"));
+			if (first != std::string::npos)
+			{
+				parts.push_back(part.substr(first, part.find_last_not_of(" \t") - first + 1));
+			}
+			start = end + 1;
+		}
+		return parts;
+	}
+
+	bool ParseNumber(const std::string& text, std::uint32_t& value)
+	{
+		char* parsed(nullptr);
+		const unsigned long number(std::strtoul(text.c_str(), &parsed, 0));
+		if (text.empty() || *parsed != '\0')
+		{
+			return false;
+		}
+		value = static_cast<std::uint32_t>(number);
+		return true;
+	}
+
+	std::string Lowercase(std::string text)
+	{
+		std::transform(text.begin(), text.end(), text.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return text;
+	}
+
+	// Creation Kit names, in enum order
+	constexpr std::array<std::string_view, static_cast<size_t>(RE::EffectSetting::Archetype::kTotal)> ArchetypeNames = {
+		"ValueModifier", "Script", "Dispel", "CureDisease", "Absorb", "DualValueModifier", "Calm", "Demoralize", "Frenzy",
+		"Disarm", "CommandSummoned", "Invisibility", "Light", "Darkness", "NightEye", "Lock", "Open", "BoundWeapon",
+		"SummonCreature", "DetectLife", "Telekinesis", "Paralysis", "Reanimate", "SoulTrap", "TurnUndead", "Guide",
+		"WerewolfFeed", "CureParalysis", "CureAddiction", "CurePoison", "Concussion", "ValueAndParts", "AccumulateMagnitude",
+		"Stagger", "PeakValueModifier", "Cloak", "Werewolf", "SlowTime", "Rally", "EnhanceWeapon", "SpawnHazard",
+		"Etherealize", "Banish", "SpawnScriptedRef", "Disguise", "GrabActor", "VampireLord"
+	};
+	static_assert(ArchetypeNames[static_cast<size_t>(RE::EffectSetting::Archetype::kValueModifier)] == "ValueModifier");
+	static_assert(ArchetypeNames[static_cast<size_t>(RE::EffectSetting::Archetype::kSlowTime)] == "SlowTime");
+
+	constexpr std::array<std::string_view, static_cast<size_t>(RE::MagicSystem::CastingType::kTotal)> CastingTypeNames = {
+		"ConstantEffect", "FireAndForget", "Concentration", "Scroll"
+	};
+	static_assert(CastingTypeNames[static_cast<size_t>(RE::MagicSystem::CastingType::kConstantEffect)] == "ConstantEffect");
+
+	// number, or name matched without regard to case
+	template <size_t N>
+	bool ParseNamed(const std::string& text, const std::array<std::string_view, N>& names, std::uint32_t& value)
+	{
+		if (ParseNumber(text, value))
+		{
+			return value < N;
+		}
+		const std::string name(Lowercase(text));
+		for (size_t index = 0; index < N; ++index)
+		{
+			if (Lowercase(std::string(names[index])) == name)
+			{
+				value = static_cast<std::uint32_t>(index);
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+PauseVetoRules PauseVetoRules::Compile(const std::string& rules, const std::string& formIDs, RE::TESDataHandler& dataHandler)
+{
+	PauseVetoRules compiled;
+	for (const std::string& text : Split(rules, SettingsCache::PauseVetoRuleSeparator))
+	{
+		Rule rule;
+		if (!ParseRule(text, dataHandler, rule))
+		{
+			REL_WARNING("PauseVetoRules entry '{}' is not valid, ignored", text);
+			continue;
+		}
+		compiled.Add(rule);
+	}
+	std::vector<RE::FormID> vetoed;
+	for (const std::string& text : Split(formIDs, ','))
+	{
+		const RE::FormID formID(ParseFormID(text, dataHandler));
+		if (formID == 0)
+		{
+			REL_WARNING("PauseVetoFormIDs entry '{}' is not valid or not loaded, ignored", text);
+			continue;
+		}
+		vetoed.push_back(formID);
+	}
+	compiled._formIDs = FormIDSet(std::move(vetoed));
+	REL_MESSAGE("Pause veto rules compiled, {} keyword rules, {} FormIDs", compiled._keywordRules.size(), compiled._formIDs.size());
+	return compiled;
+}
+
+// comma-separated field:value terms, all of which must hold - archetype, av, casting (! prefix to exclude) and keyword.
+// Archetypes, actor values and casting types may be given by name or number.
+bool PauseVetoRules::ParseRule(const std::string& text, RE::TESDataHandler& dataHandler, Rule& rule)
+{
+	for (const std::string& term : Split(text, ','))
+	{
+		const size_t colon(term.find(':'));
+		if (colon == std::string::npos)
+		{
+			return false;
+		}
+		const std::string field(Lowercase(term.substr(0, colon)));
+		const std::string value(term.substr(colon + 1));
+		std::uint32_t number(0);
+		if (field == "archetype")
+		{
+			if (!ParseNamed(value, ArchetypeNames, number))
+				return false;
+			rule.archetype = number;
+		}
+		else if (field == "av")
+		{
+			if (!ParseNumber(value, number))
+			{
+				// enum names as listed by the game, e.g. BowSpeedBonus
+				const RE::ActorValueList* actorValues(RE::ActorValueList::GetSingleton());
+				number = static_cast<std::uint32_t>(actorValues ? actorValues->LookupActorValueByName(value) : RE::ActorValue::kNone);
+			}
+			if (number >= ActorValues)
+				return false;
+			rule.actorValue = number;
+		}
+		else if (field == "casting")
+		{
+			const bool exclude(!value.empty() && value.front() == '!');
+			if (!ParseNamed(exclude ? value.substr(1) : value, CastingTypeNames, number))
+				return false;
+			const std::uint8_t castingType(static_cast<std::uint8_t>(1 << number));
+			rule.castingTypes = exclude ? static_cast<std::uint8_t>(rule.castingTypes & ~castingType) : castingType;
+		}
+		else if (field == "keyword")
+		{
+			const RE::FormID formID(ParseFormID(value, dataHandler));
+			rule.keyword = formID ? RE::TESForm::LookupByID<RE::BGSKeyword>(formID) : nullptr;
+			if (!rule.keyword)
+				return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return rule.castingTypes != 0;
+}
+
+RE::FormID PauseVetoRules::ParseFormID(const std::string& text, RE::TESDataHandler& dataHandler)
+{
+	const size_t separator(text.find('|'));
+	std::uint32_t formID(0);
+	if (separator == std::string::npos)
+	{
+		return ParseNumber(text, formID) ? formID : 0;
+	}
+	if (!ParseNumber(text.substr(separator + 1), formID))
+	{
+		return 0;
+	}
+	return dataHandler.LookupFormID(formID, std::string_view(text).substr(0, separator));
+}
+
+void PauseVetoRules::Add(const Rule& rule)
+{
+	if (rule.keyword)
+	{
+		_keywordRules.push_back(rule);
+		return;
+	}
+	for (size_t archetype = 0; archetype < Archetypes; ++archetype)
+	{
+		if (rule.archetype != Any && rule.archetype != archetype)
+			continue;
+		ArchetypeMask& mask(_archetypes[archetype]);
+		if (rule.actorValue == Any)
+		{
+			mask.anyActorValue |= rule.castingTypes;
+			continue;
+		}
+		for (size_t castingType = 0; castingType < CastingTypes; ++castingType)
+		{
+			if ((rule.castingTypes & (1 << castingType)) != 0)
+			{
+				mask.byActorValue[castingType].set(rule.actorValue);
+			}
+		}
+	}
+}
+
+bool PauseVetoRules::Matches(const Rule& rule, const size_t archetype, const size_t actorValue, const std::uint8_t castingType)
+{
+	return (rule.archetype == Any || rule.archetype == archetype) &&
+		(rule.actorValue == Any || rule.actorValue == actorValue) &&
+		(rule.castingTypes & castingType) != 0;
+}
+
+bool PauseVetoRules::Vetoes(const RE::EffectSetting& effect) const
+{
+	if (_formIDs.contains(effect.GetFormID()))
+	{
+		return true;
+	}
+	const size_t archetype(static_cast<size_t>(effect.GetArchetype()));
+	const size_t castingType(static_cast<size_t>(effect.data.castingType));
+	if (archetype >= Archetypes || castingType >= CastingTypes)
+	{
+		return false;
+	}
+	// kNone is negative, and never matches an actor value rule
+	const size_t actorValue(static_cast<size_t>(effect.data.primaryAV));
+	const std::uint8_t castingBit(static_cast<std::uint8_t>(1 << castingType));
+	const ArchetypeMask& mask(_archetypes[archetype]);
+	if ((mask.anyActorValue & castingBit) != 0 || (actorValue < ActorValues && mask.byActorValue[castingType].test(actorValue)))
+	{
+		return true;
+	}
+	for (const Rule& rule : _keywordRules)
+	{
+		if (Matches(rule, archetype, actorValue, castingBit) && effect.HasKeyword(rule.keyword))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+}
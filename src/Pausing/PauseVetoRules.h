@@ -0,0 +1,81 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Data/FormIDSet.h"
+
+namespace palu
+{
+
+// Magic Effects that must not be active when time is frozen, from the PauseVetoRules and PauseVetoFormIDs settings.
+// Rules compile at data load into a casting-type bitmask per archetype, or per archetype and actor value, plus a
+// FormID set - classifying an effect costs the same however many rules there are. Only keyword rules are checked
+// one by one.
+class PauseVetoRules
+{
+public:
+	PauseVetoRules() = default;
+
+	// resolve plugin-relative FormIDs and keywords, which needs the data handler
+	static PauseVetoRules Compile(const std::string& rules, const std::string& formIDs, RE::TESDataHandler& dataHandler);
+
+	[[nodiscard]] bool Vetoes(const RE::EffectSetting& effect) const;
+
+private:
+	static constexpr size_t Archetypes = static_cast<size_t>(RE::EffectSetting::Archetype::kTotal);
+	static constexpr size_t ActorValues = static_cast<size_t>(RE::ActorValue::kTotal);
+	static constexpr size_t CastingTypes = static_cast<size_t>(RE::MagicSystem::CastingType::kTotal);
+	static constexpr std::uint8_t AllCastingTypes = (1 << CastingTypes) - 1;
+	static constexpr std::uint32_t Any = ~0U;
+
+	struct Rule
+	{
+		std::uint32_t archetype = Any;
+		std::uint32_t actorValue = Any;
+		std::uint8_t castingTypes = AllCastingTypes;
+		const RE::BGSKeyword* keyword = nullptr;
+	};
+
+	struct ArchetypeMask
+	{
+		// casting types vetoed whatever the primary actor value
+		std::uint8_t anyActorValue = 0;
+		// actor values vetoed, per casting type
+		std::array<std::bitset<ActorValues>, CastingTypes> byActorValue{};
+	};
+
+	static bool ParseRule(const std::string& text, RE::TESDataHandler& dataHandler, Rule& rule);
+	// 0x-prefixed or decimal FormID, or Plugin.esp|0x800 relative to a plugin - 0 if invalid or not loaded
+	static RE::FormID ParseFormID(const std::string& text, RE::TESDataHandler& dataHandler);
+	static bool Matches(const Rule& rule, const size_t archetype, const size_t actorValue, const std::uint8_t castingType);
+	void Add(const Rule& rule);
+
+	std::array<ArchetypeMask, Archetypes> _archetypes{};
+	std::vector<Rule> _keywordRules;
+	FormIDSet _formIDs;
+};
+
+}
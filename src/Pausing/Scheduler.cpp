@@ -0,0 +1,79 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/Scheduler.h"
+
+namespace palu
+{
+
+Scheduler::Scheduler() : _workGuard(boost::asio::make_work_guard(_ioContext))
+{
+#if !defined(PALU_VIRTUAL_CLOCK)
+	_thread = std::jthread([this](std::stop_token stopToken) { Run(stopToken); });
+	_threadsCreated.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+Scheduler::~Scheduler()
+{
+	Stop();
+}
+
+void Scheduler::Stop()
+{
+	_workGuard.reset();
+	if (_thread.joinable())
+	{
+		_thread.request_stop();
+		_thread.join();
+	}
+}
+
+#if defined(PALU_VIRTUAL_CLOCK)
+size_t Scheduler::Poll()
+{
+	return _ioContext.poll();
+}
+#endif
+
+void Scheduler::Run(std::stop_token stopToken)
+{
+	REL_DMESSAGE("Starting scheduler thread");
+	// here rather than on the loading thread - ahead of the first job, so every deadline is armed on the calibrated clock
+	PluginClock::Calibrate();
+	// stop request interrupts any pending wait, including PauseDelay
+	std::stop_callback onStop(stopToken, [this] { _ioContext.stop(); });
+	// keep the worker alive across a failed job, the next load screen still needs it
+	while (!_ioContext.stopped())
+	{
+		try
+		{
+			_ioContext.run();
+		}
+		catch (const std::exception& exc)
+		{
+			REL_ERROR("Scheduler job failed: {}", exc.what());
+		}
+	}
+	REL_DMESSAGE("Exiting scheduler thread");
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <boost/asio.hpp>
+#include <atomic>
+#include <thread>
+
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+// Single long-lived worker that runs all deferred pause work - freeze, resume-timeout and unpause.
+// Created once with PauseHandler so that load screens do not create or join a thread on the game thread.
+class Scheduler
+{
+public:
+	// deadlines use the plugin clock, so they compare exactly with time points taken on other threads
+	using Timer = boost::asio::basic_waitable_timer<PluginClock>;
+
+	Scheduler();
+	~Scheduler();
+
+	Scheduler(const Scheduler&) = delete;
+	Scheduler(Scheduler&&) = delete;
+	Scheduler& operator=(const Scheduler&) = delete;
+	Scheduler& operator=(Scheduler&&) = delete;
+
+	// queue a job to run on the scheduler thread, jobs run in the order posted
+	template <typename Job>
+	void Post(Job&& job)
+	{
+		boost::asio::post(_ioContext, std::forward<Job>(job));
+	}
+
+	// timers bound to this context complete on the scheduler thread
+	boost::asio::io_context& Context() { return _ioContext; }
+
+	// request stop via the worker's stop_token and join - pending timers are abandoned, safe to call more than once
+	void Stop();
+
+#if defined(PALU_VIRTUAL_CLOCK)
+	// off-game harness only - there is no worker, the harness runs every job and timer due on virtual time from its own
+	// thread
+	size_t Poll();
+#endif
+
+	// instrumentation - expected to remain at 1 for the life of the process
+	[[nodiscard]] static size_t ThreadsCreated() { return _threadsCreated.load(std::memory_order_relaxed); }
+
+private:
+	void Run(std::stop_token stopToken);
+
+	boost::asio::io_context _ioContext;
+	boost::asio::executor_work_guard<boost::asio::io_context::executor_type> _workGuard;
+	std::jthread _thread;
+
+	inline static std::atomic<size_t> _threadsCreated{ 0 };
+};
+
+}
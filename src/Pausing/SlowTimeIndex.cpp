@@ -0,0 +1,176 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Pausing/SlowTimeIndex.h"
+#include "Utilities/utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <windows.h>
+
+namespace palu
+{
+
+namespace
+{
+	// FNV-1a, 64-bit
+	constexpr std::uint64_t FingerprintBasis = 0xcbf29ce484222325ULL;
+	constexpr std::uint64_t FingerprintPrime = 0x100000001b3ULL;
+
+	void HashBytes(std::uint64_t& hash, const void* data, const size_t length)
+	{
+		const unsigned char* bytes(static_cast<const unsigned char*>(data));
+		for (size_t index = 0; index < length; ++index)
+		{
+			hash = (hash ^ bytes[index]) * FingerprintPrime;
+		}
+	}
+
+	template <typename T>
+	void HashValue(std::uint64_t& hash, const T value)
+	{
+		HashBytes(hash, &value, sizeof(value));
+	}
+}
+
+SlowTimeIndex::SlowTimeIndex(const std::filesystem::path& fileName) : _fileName(fileName)
+{
+}
+
+SlowTimeIndex::~SlowTimeIndex()
+{
+	Unmap();
+}
+
+std::uint64_t SlowTimeIndex::Fingerprint(RE::TESDataHandler& dataHandler, const std::string_view configuration)
+{
+	const std::filesystem::path dataPath(FileUtils::GetGamePath() + L"Data");
+	std::uint64_t hash(FingerprintBasis);
+	HashBytes(hash, configuration.data(), configuration.length());
+	for (RE::TESFile* file : dataHandler.files)
+	{
+		if (!file)
+			continue;
+		const std::string_view name(file->GetFilename());
+		HashBytes(hash, name.data(), name.length());
+		HashValue(hash, file->GetCompileIndex());
+		HashValue(hash, file->GetSmallFileCompileIndex());
+		// size and last write time from one query - a missing plugin hashes as zeros
+		WIN32_FILE_ATTRIBUTE_DATA attributes{};
+		if (!GetFileAttributesExW((dataPath / name).c_str(), GetFileExInfoStandard, &attributes))
+		{
+			attributes = WIN32_FILE_ATTRIBUTE_DATA{};
+		}
+		HashValue(hash, attributes.nFileSizeHigh);
+		HashValue(hash, attributes.nFileSizeLow);
+		HashValue(hash, attributes.ftLastWriteTime.dwHighDateTime);
+		HashValue(hash, attributes.ftLastWriteTime.dwLowDateTime);
+	}
+	return hash;
+}
+
+std::optional<std::span<const RE::FormID>> SlowTimeIndex::Load(const std::uint64_t fingerprint)
+{
+	Unmap();
+	HANDLE file(CreateFileW(_fileName.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		REL_MESSAGE("No slow-time effect index, classify Magic Effects");
+		return std::nullopt;
+	}
+	_file = file;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+	{
+		REL_WARNING("Slow-time effect index truncated, classify Magic Effects");
+		Unmap();
+		return std::nullopt;
+	}
+	_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	_view = _mapping ? MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!_view)
+	{
+		REL_WARNING("Cannot map slow-time effect index, error {}", GetLastError());
+		Unmap();
+		return std::nullopt;
+	}
+	const Header& header(*static_cast<const Header*>(_view));
+	if (header.magic != FileMagic || header.version != FileVersion ||
+		static_cast<LONGLONG>(sizeof(Header) + header.count * sizeof(RE::FormID)) != size.QuadPart)
+	{
+		REL_WARNING("Slow-time effect index invalid, classify Magic Effects");
+		Unmap();
+		return std::nullopt;
+	}
+	if (header.fingerprint != fingerprint)
+	{
+		REL_MESSAGE("Load order changed since slow-time effect index was saved, classify Magic Effects");
+		Unmap();
+		return std::nullopt;
+	}
+	const std::span<const RE::FormID> formIDs(
+		reinterpret_cast<const RE::FormID*>(static_cast<const unsigned char*>(_view) + sizeof(Header)), header.count);
+	if (std::adjacent_find(formIDs.begin(), formIDs.end(), std::greater_equal<RE::FormID>()) != formIDs.end())
+	{
+		REL_WARNING("Slow-time effect index not sorted, classify Magic Effects");
+		Unmap();
+		return std::nullopt;
+	}
+	return formIDs;
+}
+
+bool SlowTimeIndex::Save(const std::uint64_t fingerprint, const FormIDSet& formIDs)
+{
+	// a mapped file cannot be rewritten
+	Unmap();
+	std::ofstream output(_fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output)
+	{
+		REL_WARNING("Cannot save slow-time effect index");
+		return false;
+	}
+	const Header header{ FileMagic, FileVersion, fingerprint, static_cast<std::uint32_t>(formIDs.size()), 0 };
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(formIDs.FormIDs().data()), formIDs.size() * sizeof(RE::FormID));
+	return static_cast<bool>(output);
+}
+
+void SlowTimeIndex::Unmap()
+{
+	if (_view)
+	{
+		UnmapViewOfFile(_view);
+		_view = nullptr;
+	}
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+	}
+	if (_file)
+	{
+		CloseHandle(_file);
+		_file = nullptr;
+	}
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "Data/FormIDSet.h"
+
+namespace palu
+{
+
+// Slow-time Magic Effect FormIDs classified on an earlier launch, in a small file next to the INI keyed by a fingerprint
+// of the load order. A file with matching fingerprint is memory-mapped and its FormIDs used in place, anything else
+// means classify afresh and rewrite the file.
+class SlowTimeIndex
+{
+public:
+	SlowTimeIndex() = delete;
+	explicit SlowTimeIndex(const std::filesystem::path& fileName);
+	~SlowTimeIndex();
+
+	SlowTimeIndex(const SlowTimeIndex&) = delete;
+	SlowTimeIndex(SlowTimeIndex&&) = delete;
+	SlowTimeIndex& operator=(const SlowTimeIndex&) = delete;
+	SlowTimeIndex& operator=(SlowTimeIndex&&) = delete;
+
+	// plugin names in load order with their compile indices, sizes and last write times, plus the classification settings
+	[[nodiscard]] static std::uint64_t Fingerprint(RE::TESDataHandler& dataHandler, const std::string_view configuration);
+
+	// sorted FormIDs viewed in the mapped file, valid while this object lives - nullopt if absent, stale or invalid
+	[[nodiscard]] std::optional<std::span<const RE::FormID>> Load(const std::uint64_t fingerprint);
+	bool Save(const std::uint64_t fingerprint, const FormIDSet& formIDs);
+
+private:
+	struct Header
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint64_t fingerprint;
+		std::uint32_t count;
+		std::uint32_t reserved;
+	};
+	static_assert(sizeof(Header) == 24);
+
+	static constexpr std::uint32_t FileMagic = 0x534c4150;	// 'PALS'
+	static constexpr std::uint32_t FileVersion = 1;
+
+	void Unmap();
+
+	std::filesystem::path _fileName;
+	// Windows file, mapping and view handles while the index is mapped
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+	const void* _view = nullptr;
+};
+
+}
@@ -0,0 +1,63 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#include "PrecompiledHeaders.h"
+
+#include "Utilities/PluginClock.h"
+
+namespace palu
+{
+
+void PluginClock::Calibrate()
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	int registers[4];
+	__cpuid(registers, 0x80000000);
+	bool invariantTsc(false);
+	if (static_cast<unsigned int>(registers[0]) >= 0x80000007)
+	{
+		__cpuid(registers, 0x80000007);
+		invariantTsc = (registers[3] & (1 << 8)) != 0;
+	}
+	if (!invariantTsc)
+	{
+		REL_MESSAGE("No invariant TSC, PluginClock uses steady_clock");
+		return;
+	}
+	const auto steadyStart(std::chrono::steady_clock::now());
+	const std::uint64_t ticksStart(__rdtsc());
+	std::this_thread::sleep_for(CalibrationPeriod);
+	const auto steadyEnd(std::chrono::steady_clock::now());
+	const std::uint64_t ticksEnd(__rdtsc());
+	if (ticksEnd <= ticksStart)
+	{
+		REL_WARNING("TSC did not advance, PluginClock uses steady_clock");
+		return;
+	}
+	const double nanosPerTick(static_cast<double>(std::chrono::duration_cast<duration>(steadyEnd - steadyStart).count()) /
+		static_cast<double>(ticksEnd - ticksStart));
+	_calibration = { ticksEnd, std::chrono::duration_cast<duration>(steadyEnd.time_since_epoch()).count(), nanosPerTick };
+	_calibrated.store(true, std::memory_order_release);
+	REL_MESSAGE("PluginClock uses TSC at {:.3f} GHz", 1.0 / nanosPerTick);
+#else
+	REL_MESSAGE("PluginClock uses steady_clock");
+#endif
+}
+
+}
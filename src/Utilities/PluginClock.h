@@ -0,0 +1,89 @@
+/*************************************************************************
+PauseAfterLoadUnscripted
+Copyright (c) Steve Townsend 2021
+
+>>> SOURCE LICENSE >>>
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation (www.fsf.org); either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+A copy of the GNU General Public License is available at
+http://www.fsf.org/licensing/licenses
+>>> END OF LICENSE >>>
+*************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace palu
+{
+
+// Single monotonic clock for all plugin timing. Reads the invariant TSC where available, scaled to nanoseconds by
+// constants fixed once at startup, so time points taken on any thread compare exactly. Otherwise, and until the
+// calibration is published, reads std::chrono::steady_clock, which shares the same epoch.
+class PluginClock
+{
+public:
+	using rep = std::int64_t;
+	using period = std::nano;
+	using duration = std::chrono::duration<rep, period>;
+	using time_point = std::chrono::time_point<PluginClock>;
+	static constexpr bool is_steady = true;
+
+	static time_point now() noexcept
+	{
+#if defined(PALU_VIRTUAL_CLOCK)
+		return time_point(duration(_virtualNanos.load(std::memory_order_acquire)));
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+		if (_calibrated.load(std::memory_order_acquire))
+		{
+			return time_point(duration(_calibration.baseNanos +
+				static_cast<rep>(static_cast<double>(__rdtsc() - _calibration.baseTicks) * _calibration.nanosPerTick)));
+		}
+#endif
+		return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+	}
+
+#if defined(PALU_VIRTUAL_CLOCK)
+	// off-game harness only - time stands still until the harness moves it
+	static void Advance(const duration elapsed) { _virtualNanos.fetch_add(elapsed.count(), std::memory_order_acq_rel); }
+#endif
+
+	// measure TSC rate against steady_clock and publish it - call once, from the scheduler worker before it runs any job,
+	// so the sample period does not hold up plugin load
+	static void Calibrate();
+	[[nodiscard]] static bool UsesTsc() { return _calibrated.load(std::memory_order_acquire); }
+
+private:
+	struct Calibration
+	{
+		std::uint64_t baseTicks;
+		rep baseNanos;
+		double nanosPerTick;
+	};
+
+	static constexpr std::chrono::milliseconds CalibrationPeriod{ 20 };
+
+	// written once before _calibrated is set, read only after
+	inline static Calibration _calibration{ 0, 0, 0.0 };
+	inline static std::atomic<bool> _calibrated{ false };
+#if defined(PALU_VIRTUAL_CLOCK)
+	// starts well clear of the epoch, which callers use as "never"
+	inline static std::atomic<rep> _virtualNanos{ 1000000000 };
+#endif
+};
+
+}
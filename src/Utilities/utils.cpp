@@ -20,6 +20,7 @@ http://www.fsf.org/licensing/licenses
 #include "PrecompiledHeaders.h"
 
 #include "Utilities/utils.h"
+#include "Utilities/PluginClock.h"
 
 #include <psapi.h>
 #include <fstream>
@@ -140,18 +141,8 @@ namespace utils
 namespace WindowsUtils
 {
 	unsigned long long microsecondsNow() {
-		static LARGE_INTEGER s_frequency;
-		static BOOL s_use_qpc = QueryPerformanceFrequency(&s_frequency);
-		if (s_use_qpc) {
-			LARGE_INTEGER now;
-			QueryPerformanceCounter(&now);
-			// To guard against loss-of-precision, we convert
-			// to microseconds *before* dividing by ticks-per-second.
-			return static_cast<unsigned long long>((1000000LL * now.QuadPart) / s_frequency.QuadPart);
-		}
-		else {
-			return GetTickCount64() * 1000ULL;
-		}
+		return static_cast<unsigned long long>(
+			std::chrono::duration_cast<std::chrono::microseconds>(palu::PluginClock::now().time_since_epoch()).count());
 	}
 
 	void LogProcessWorkingSet()
@@ -175,8 +166,7 @@ namespace WindowsUtils
 		// flush log output here
 		PALULogger->flush();
 
-		auto nextRunTime = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(static_cast<long long>(delaySeconds * 1000.0));
-		std::this_thread::sleep_until(nextRunTime);
+		std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(delaySeconds * 1000.0)));
 	}
 
 	ScopedTimer::ScopedTimer(const std::string& context) : m_startTime(microsecondsNow()), m_context(context) {}
@@ -21,6 +21,7 @@ http://www.fsf.org/licensing/licenses
 
 #include "Data/SettingsCache.h"
 #include "Pausing/PauseHandler.h"
+#include "Pausing/PauseTimeline.h"
 #include "Utilities/version.h"
 #if _DEBUG
 #include "Utilities/LogStackWalker.h"
@@ -76,10 +77,12 @@ void SKSEMessageHandler(SKSE::MessagingInterface::Message* msg)
 
 	case SKSE::MessagingInterface::kPostLoadGame:
 		DBG_MESSAGE("kPostLoadGame message");
+		pauseHandler.value().OnGameLoaded();
 		break;
 
 	case SKSE::MessagingInterface::kNewGame:
 		DBG_MESSAGE("kNewGame message");
+		pauseHandler.value().OnGameLoaded();
 		break;
 
 	default:
@@ -142,6 +145,12 @@ void InitializeDiagnostics()
 		fileName.append(".log");
 		PALULogger = spdlog::basic_logger_mt(LoggerName, fileName, true);
 		PALULogger->set_pattern("%Y-%m-%d %T.%e %8l %6t %v");
+
+		std::string timelineName(logPath.generic_string());
+		timelineName.append("/");
+		timelineName.append(PALU_NAME);
+		timelineName.append("_Timeline.log");
+		palu::PauseTimeline::Instance().SetDumpFile(timelineName);
 	}
 	catch (const spdlog::spdlog_ex&)
 	{